@@ -0,0 +1,284 @@
+/**
+ * @file bench_common.c
+ *
+ * @brief measurement and output shared by the benchmarks.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#define _POSIX_C_SOURCE 200112L
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+#if defined(__VERSION__)
+#define COMPILER __VERSION__
+#else
+#define COMPILER "unknown"
+#endif
+
+#define DEFAULT_REPS 11
+#define MAX_REPS 1001
+/*
+ * time of one repetition aimed at by calibration.
+ */
+#define CALIBRATE_NS 5e6
+#define PERCENTILE_COUNT 5
+
+static const int percentiles[PERCENTILE_COUNT] = {0, 10, 50, 90, 100};
+static uint64_t sink;
+
+static double now_ns(void);
+static uint64_t cycles(void);
+static int compare_double(const void * a, const void * b);
+static double percentile(const double sorted[], int size, int p);
+static size_t calibrate(bench_body_t body, void * arg);
+static void print_result(bench_options_t * opt, const char * function,
+			 const char * variant, const char * kernel,
+			 const char * mode, double ns[], double cyc[]);
+
+/* ================
+ * PUBLIC FUNCTIONS
+   ================ */
+int bench_parse_options(bench_options_t * opt, int argc, char * argv[],
+			size_t default_count)
+{
+    opt->count = default_count;
+    opt->reps = DEFAULT_REPS;
+    opt->filter = NULL;
+    opt->format = BENCH_TEXT;
+    opt->printed = 0;
+    for (int i = 1; i < argc; i++) {
+	if (i + 1 >= argc) {
+	    return -1;
+	}
+	if (strcmp(argv[i], "-n") == 0) {
+	    opt->count = strtoul(argv[++i], NULL, 10);
+	} else if (strcmp(argv[i], "-r") == 0) {
+	    opt->reps = atoi(argv[++i]);
+	} else if (strcmp(argv[i], "-f") == 0) {
+	    opt->filter = argv[++i];
+	} else if (strcmp(argv[i], "-o") == 0) {
+	    i++;
+	    if (strcmp(argv[i], "text") == 0) {
+		opt->format = BENCH_TEXT;
+	    } else if (strcmp(argv[i], "csv") == 0) {
+		opt->format = BENCH_CSV;
+	    } else if (strcmp(argv[i], "json") == 0) {
+		opt->format = BENCH_JSON;
+	    } else {
+		return -1;
+	    }
+	} else {
+	    return -1;
+	}
+    }
+    if (opt->reps < 1 || opt->reps > MAX_REPS) {
+	return -1;
+    }
+    return 0;
+}
+
+void bench_usage(const char * program)
+{
+    printf("%s [-n count] [-r reps] [-f filter] [-o text|csv|json]\n",
+	   program);
+}
+
+int bench_selected(const bench_options_t * opt, const char * function,
+		   const char * variant)
+{
+    return opt->filter == NULL
+	|| strstr(function, opt->filter) != NULL
+	|| strstr(variant, opt->filter) != NULL;
+}
+
+void bench_begin(bench_options_t * opt, const char * kernel)
+{
+    if (opt->format == BENCH_JSON) {
+	printf("{\"compiler\": \"%s\", \"default_kernel\": \"%s\",\n"
+	       " \"results\": [", COMPILER, kernel);
+    }
+}
+
+void bench_end(bench_options_t * opt)
+{
+    if (opt->format == BENCH_JSON) {
+	printf("\n]}\n");
+    }
+    if (sink == 1) {
+	fprintf(stderr, "\n");
+    }
+}
+
+void bench_run(bench_options_t * opt, bench_body_t body, void * arg,
+	       const char * function, const char * variant,
+	       const char * kernel, const char * mode)
+{
+    static double ns[MAX_REPS];
+    static double cyc[MAX_REPS];
+    size_t count = opt->count;
+    if (count == 0) {
+	count = calibrate(body, arg);
+    } else {
+	sink += body(arg, count);
+    }
+    for (int r = 0; r < opt->reps; r++) {
+	double t0 = now_ns();
+	uint64_t c0 = cycles();
+	sink += body(arg, count);
+	uint64_t c1 = cycles();
+	double t1 = now_ns();
+	ns[r] = (t1 - t0) / count;
+	cyc[r] = (double)(c1 - c0) / count;
+    }
+    size_t saved = opt->count;
+    opt->count = count;
+    print_result(opt, function, variant, kernel, mode, ns, cyc);
+    opt->count = saved;
+}
+
+/* ================
+ * PRIVATE FUNCTIONS
+   ================ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t cycles(void)
+{
+#if defined(HAVE_RDTSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int compare_double(const void * a, const void * b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * nearest rank percentile.
+ * @param sorted sorted array
+ * @param size number of elements
+ * @param p percent
+ * @return the percentile
+ */
+static double percentile(const double sorted[], int size, int p)
+{
+    int rank = (p * size + 99) / 100;
+    if (rank < 1) {
+	rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+/**
+ * find the count which takes about CALIBRATE_NS, doubling from 1.
+ * This also warms up.
+ * @param body benchmark body
+ * @param arg argument of body
+ * @return count
+ */
+static size_t calibrate(bench_body_t body, void * arg)
+{
+    size_t count = 1;
+    for (;;) {
+	double t0 = now_ns();
+	sink += body(arg, count);
+	double t = now_ns() - t0;
+	if (t >= CALIBRATE_NS) {
+	    return count;
+	}
+	if (t * 4 < CALIBRATE_NS) {
+	    count *= 4;
+	} else {
+	    count *= 2;
+	}
+    }
+}
+
+static void print_result(bench_options_t * opt, const char * function,
+			 const char * variant, const char * kernel,
+			 const char * mode, double ns[], double cyc[])
+{
+    double nsp[PERCENTILE_COUNT];
+    double cycp[PERCENTILE_COUNT];
+    qsort(ns, opt->reps, sizeof(double), compare_double);
+    qsort(cyc, opt->reps, sizeof(double), compare_double);
+    for (int i = 0; i < PERCENTILE_COUNT; i++) {
+	nsp[i] = percentile(ns, opt->reps, percentiles[i]);
+	cycp[i] = percentile(cyc, opt->reps, percentiles[i]);
+    }
+    if (opt->format == BENCH_TEXT) {
+	if (!opt->printed) {
+	    printf("%-32s %-20s %-7s %-10s %12s %12s %12s %12s\n",
+		   "function", "variant", "kernel", "mode",
+		   "ns_min", "ns_p50", "ns_p90", "cyc_p50");
+	}
+	printf("%-32s %-20s %-7s %-10s %12.3f %12.3f %12.3f",
+	       function, variant, kernel, mode, nsp[0], nsp[2], nsp[3]);
+#if defined(HAVE_RDTSC)
+	printf(" %12.3f\n", cycp[2]);
+#else
+	printf(" %12s\n", "-");
+#endif
+    } else if (opt->format == BENCH_CSV) {
+	if (!opt->printed) {
+	    printf("function,variant,kernel,mode,count,reps,"
+		   "ns_min,ns_p10,ns_p50,ns_p90,ns_max,"
+		   "cycles_min,cycles_p10,cycles_p50,cycles_p90,"
+		   "cycles_max\n");
+	}
+	printf("%s,%s,%s,%s,%zu,%d", function, variant, kernel, mode,
+	       opt->count, opt->reps);
+	for (int i = 0; i < PERCENTILE_COUNT; i++) {
+	    printf(",%.4f", nsp[i]);
+	}
+	for (int i = 0; i < PERCENTILE_COUNT; i++) {
+#if defined(HAVE_RDTSC)
+	    printf(",%.4f", cycp[i]);
+#else
+	    printf(",");
+#endif
+	}
+	printf("\n");
+    } else {
+	printf("%s\n    {\"function\": \"%s\", \"variant\": \"%s\", "
+	       "\"kernel\": \"%s\", \"mode\": \"%s\",\n"
+	       "     \"count\": %zu, \"reps\": %d,\n     \"ns\": {",
+	       opt->printed ? "," : "", function, variant, kernel, mode,
+	       opt->count, opt->reps);
+	for (int i = 0; i < PERCENTILE_COUNT; i++) {
+	    printf("%s\"p%d\": %.4f", i > 0 ? ", " : "", percentiles[i],
+		   nsp[i]);
+	}
+	printf("},\n     \"cycles\": ");
+#if defined(HAVE_RDTSC)
+	printf("{");
+	for (int i = 0; i < PERCENTILE_COUNT; i++) {
+	    printf("%s\"p%d\": %.4f", i > 0 ? ", " : "", percentiles[i],
+		   cycp[i]);
+	}
+	printf("}}");
+#else
+	printf("null}");
+#endif
+    }
+    opt->printed = 1;
+    fflush(stdout);
+}
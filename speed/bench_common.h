@@ -0,0 +1,72 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+/**
+ * @file bench_common.h
+ *
+ * @brief measurement and output shared by the benchmarks.
+ *
+ * A benchmark body does \b count units of work, values or calls, and
+ * returns a checksum so that the work is not removed by the compiler.
+ * bench_run() runs it once for warm up, then times it \b reps times,
+ * and reports the percentiles over the repetitions of ns/unit and
+ * rdtsc cycles/unit as text, CSV or JSON.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    typedef enum {BENCH_TEXT, BENCH_CSV, BENCH_JSON} bench_format_t;
+
+    typedef struct {
+	/* units per repetition, 0 means calibrated by bench_run() */
+	size_t count;
+	int reps;
+	const char * filter;
+	bench_format_t format;
+	int printed;
+    } bench_options_t;
+
+    typedef uint64_t (*bench_body_t)(void * arg, size_t count);
+
+    /**
+     * parse [-n count] [-r reps] [-f filter] [-o text|csv|json].
+     * @return 0 if success, -1 if the arguments are wrong.
+     */
+    int bench_parse_options(bench_options_t * opt, int argc, char * argv[],
+			    size_t default_count);
+
+    void bench_usage(const char * program);
+
+    /**
+     * @return non zero if function or variant contains the filter.
+     */
+    int bench_selected(const bench_options_t * opt, const char * function,
+		       const char * variant);
+
+    /**
+     * start the output. The JSON output records the compiler and
+     * \b kernel, the default kernel of bulk generation.
+     */
+    void bench_begin(bench_options_t * opt, const char * kernel);
+
+    void bench_end(bench_options_t * opt);
+
+    /**
+     * measure body and print one result.
+     */
+    void bench_run(bench_options_t * opt, bench_body_t body, void * arg,
+		   const char * function, const char * variant,
+		   const char * kernel, const char * mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,361 @@
+/**
+ * @file bench_setup.c
+ *
+ * @brief benchmark of seeding, jump polynomial calculation and jump.
+ *
+ * The time per call is measured for
+ * - xsadd_init() and xsadd_init_by_array() with keys of various
+ *   lengths,
+ * - xsadd_calculate_jump_polynomial(), xsadd_calculate_jump_poly()
+ *   and xsadd_jump() for step sizes times multipliers,
+ * - xsadd_jump_by_polynomial() and xsadd_jump_by_poly() for each step
+ *   size,
+ * - xsadd_calculate_jump_poly_u128() for steps with all bits set,
+ * - making n streams jumped by xsadd_jump_base_step, by
+ *   xsadd_spawn_streams() and by repeating xsadd_jump(),
+ * - moving forward and backward by distances 2^k - 1 by stepping,
+ *   by jumping, and by xsadd_discard() and xsadd_rewind(), which
+ *   choose one of them by DISCARD_JUMP_THRESHOLD and
+ *   REWIND_JUMP_THRESHOLD in xsadd.c. The crossover of stepping and
+ *   jumping is shown by "bench_setup -f distance=". The cost of jump
+ *   depends on the number of set bits of the distance, so all bits
+ *   are set as the worst case.
+ *
+ * The number of calls per repetition is calibrated to about 5ms
+ * unless -n is given. The output format is the same as bench_xsadd,
+ * see bench_common.h, so that results can be compared between builds.
+ *
+ * usage: bench_setup [-n count] [-r reps] [-f filter] [-o text|csv|json]
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include "bench_common.h"
+#include "xsadd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#define LABEL_SIZE 64
+#define MAX_KEY_SIZE 262144
+#define MAX_STREAMS 4096
+
+typedef struct {
+    const char * label;
+    const char * base;
+} step_t;
+
+/*
+ * step sizes in the format of base_step. 3^41 is
+ * xsadd_jump_base_step.
+ */
+static const step_t steps[] = {
+    {"2^16", "10000"},
+    {"2^32", "100000000"},
+    {"2^64", "10000000000000000"},
+    {"3^41", "1FA2A1CF67B5FB863"},
+    {"2^128-1", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"}
+};
+
+#define STEP_COUNT (sizeof(steps) / sizeof(steps[0]))
+
+static const uint32_t muls[] = {1, 1000, 4294967295U};
+
+#define MUL_COUNT (sizeof(muls) / sizeof(muls[0]))
+
+static const int key_sizes[] = {1, 4, 64, 1024, 16384, MAX_KEY_SIZE};
+
+#define KEY_SIZE_COUNT (sizeof(key_sizes) / sizeof(key_sizes[0]))
+
+static const int u128_bits[] = {16, 32, 64, 128};
+
+#define U128_COUNT (sizeof(u128_bits) / sizeof(u128_bits[0]))
+
+static const size_t stream_counts[] = {8, 64, 512, MAX_STREAMS};
+
+#define STREAM_COUNT (sizeof(stream_counts) / sizeof(stream_counts[0]))
+
+#define MIN_DISTANCE_BITS 4
+#define MAX_DISTANCE_BITS 20
+
+/*
+ * argument of benchmark bodies, only the members used by the body are
+ * set.
+ */
+typedef struct {
+    xsadd_t xsadd;
+    uint32_t * key;
+    int key_size;
+    const char * base;
+    uint32_t mul;
+    char jump_str[33];
+    xsadd_jump_poly_t jump_poly;
+    uint64_t step_hi;
+    uint64_t step_lo;
+    xsadd_t * streams;
+    size_t stream_count;
+    uint64_t distance;
+} setup_arg;
+
+/* ================
+ * BENCHMARK BODIES
+   ================ */
+static uint64_t body_init(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_init(&a->xsadd, (uint32_t)i);
+	sum += a->xsadd.state[0];
+    }
+    return sum;
+}
+
+static uint64_t body_init_by_array(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+	a->key[0] = (uint32_t)i;
+	xsadd_init_by_array(&a->xsadd, a->key, a->key_size);
+	sum += a->xsadd.state[0];
+    }
+    return sum;
+}
+
+static uint64_t body_calculate_jump_polynomial(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_calculate_jump_polynomial(a->jump_str, a->mul, a->base);
+	sum += (unsigned char)a->jump_str[0];
+    }
+    return sum;
+}
+
+static uint64_t body_calculate_jump_poly(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_calculate_jump_poly(&a->jump_poly, a->mul, a->base);
+	sum += a->jump_poly.poly[0];
+    }
+    return sum;
+}
+
+static uint64_t body_calculate_jump_poly_u128(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_calculate_jump_poly_u128(&a->jump_poly, a->step_hi,
+				       a->step_lo);
+	sum += a->jump_poly.poly[0];
+    }
+    return sum;
+}
+
+static uint64_t body_jump(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_jump(&a->xsadd, a->mul, a->base);
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_jump_by_polynomial(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_jump_by_polynomial(&a->xsadd, a->jump_str);
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_jump_by_poly(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_jump_by_poly(&a->xsadd, &a->jump_poly);
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_spawn_streams(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+	a->xsadd.state[0] = (uint32_t)i + 1;
+	xsadd_spawn_streams(&a->xsadd, a->streams, a->stream_count,
+			    a->step_hi, a->step_lo);
+	sum += a->streams[a->stream_count - 1].state[0];
+    }
+    return sum;
+}
+
+static uint64_t body_spawn_by_jump(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+	a->xsadd.state[0] = (uint32_t)i + 1;
+	a->streams[0] = a->xsadd;
+	for (size_t j = 1; j < a->stream_count; j++) {
+	    a->streams[j] = a->streams[j - 1];
+	    xsadd_jump(&a->streams[j], 1, xsadd_jump_base_step);
+	}
+	sum += a->streams[a->stream_count - 1].state[0];
+    }
+    return sum;
+}
+
+static uint64_t body_step(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	for (uint64_t j = 0; j < a->distance; j++) {
+	    xsadd_next_state(&a->xsadd);
+	}
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_jump_u128(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_jump_u128(&a->xsadd, 0, a->distance);
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_discard(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_discard(&a->xsadd, a->distance);
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_step_back(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	for (uint64_t j = 0; j < a->distance; j++) {
+	    xsadd_prev_state(&a->xsadd);
+	}
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_jump_back_u128(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_jump_back_u128(&a->xsadd, 0, a->distance);
+    }
+    return a->xsadd.state[0];
+}
+
+static uint64_t body_rewind(void * arg, size_t count)
+{
+    setup_arg * a = (setup_arg *)arg;
+    for (size_t i = 0; i < count; i++) {
+	xsadd_rewind(&a->xsadd, a->distance);
+    }
+    return a->xsadd.state[0];
+}
+
+static void run(bench_options_t * opt, bench_body_t body, setup_arg * arg,
+		const char * function, const char * variant)
+{
+    if (bench_selected(opt, function, variant)) {
+	bench_run(opt, body, arg, function, variant, "-", "call");
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    bench_options_t opt;
+    setup_arg arg;
+    char label[LABEL_SIZE];
+    if (bench_parse_options(&opt, argc, argv, 0) != 0) {
+	bench_usage(argv[0]);
+	return 1;
+    }
+    arg.key = (uint32_t *)malloc(MAX_KEY_SIZE * sizeof(uint32_t));
+    arg.streams = (xsadd_t *)malloc(MAX_STREAMS * sizeof(xsadd_t));
+    if (arg.key == NULL || arg.streams == NULL) {
+	printf("can't allocate memory\n");
+	return 1;
+    }
+    for (int i = 0; i < MAX_KEY_SIZE; i++) {
+	arg.key[i] = (uint32_t)i * UINT32_C(2654435769);
+    }
+    xsadd_init(&arg.xsadd, 1234);
+    bench_begin(&opt, xsadd_kernel_name());
+    run(&opt, body_init, &arg, "xsadd_init", "-");
+    for (size_t i = 0; i < KEY_SIZE_COUNT; i++) {
+	arg.key_size = key_sizes[i];
+	snprintf(label, LABEL_SIZE, "key=%d", key_sizes[i]);
+	run(&opt, body_init_by_array, &arg, "xsadd_init_by_array", label);
+    }
+    for (size_t i = 0; i < STEP_COUNT; i++) {
+	for (size_t j = 0; j < MUL_COUNT; j++) {
+	    arg.base = steps[i].base;
+	    arg.mul = muls[j];
+	    snprintf(label, LABEL_SIZE, "step=%s*%" PRIu32, steps[i].label,
+		     muls[j]);
+	    run(&opt, body_calculate_jump_polynomial, &arg,
+		"xsadd_calculate_jump_polynomial", label);
+	    run(&opt, body_calculate_jump_poly, &arg,
+		"xsadd_calculate_jump_poly", label);
+	    run(&opt, body_jump, &arg, "xsadd_jump", label);
+	}
+    }
+    for (size_t i = 0; i < STEP_COUNT; i++) {
+	xsadd_calculate_jump_polynomial(arg.jump_str, 1, steps[i].base);
+	xsadd_calculate_jump_poly(&arg.jump_poly, 1, steps[i].base);
+	snprintf(label, LABEL_SIZE, "step=%s", steps[i].label);
+	run(&opt, body_jump_by_polynomial, &arg, "xsadd_jump_by_polynomial",
+	    label);
+	run(&opt, body_jump_by_poly, &arg, "xsadd_jump_by_poly", label);
+    }
+    for (size_t i = 0; i < U128_COUNT; i++) {
+	int bits = u128_bits[i];
+	arg.step_hi = bits > 64 ? UINT64_MAX >> (128 - bits) : 0;
+	arg.step_lo = bits >= 64 ? UINT64_MAX : (UINT64_C(1) << bits) - 1;
+	snprintf(label, LABEL_SIZE, "step=2^%d-1", bits);
+	run(&opt, body_calculate_jump_poly_u128, &arg,
+	    "xsadd_calculate_jump_poly_u128", label);
+    }
+    /* 3^41 = xsadd_jump_base_step */
+    arg.step_hi = 1;
+    arg.step_lo = UINT64_C(0xFA2A1CF67B5FB863);
+    for (size_t i = 0; i < STREAM_COUNT; i++) {
+	arg.stream_count = stream_counts[i];
+	snprintf(label, LABEL_SIZE, "n=%zu", stream_counts[i]);
+	run(&opt, body_spawn_streams, &arg, "xsadd_spawn_streams", label);
+	run(&opt, body_spawn_by_jump, &arg, "spawn_by_xsadd_jump", label);
+    }
+    for (int k = MIN_DISTANCE_BITS; k <= MAX_DISTANCE_BITS; k++) {
+	arg.distance = (UINT64_C(1) << k) - 1;
+	snprintf(label, LABEL_SIZE, "distance=2^%d-1", k);
+	run(&opt, body_step, &arg, "step_by_xsadd_next_state", label);
+	run(&opt, body_jump_u128, &arg, "xsadd_jump_u128", label);
+	run(&opt, body_discard, &arg, "xsadd_discard", label);
+	run(&opt, body_step_back, &arg, "step_by_xsadd_prev_state", label);
+	run(&opt, body_jump_back_u128, &arg, "xsadd_jump_back_u128", label);
+	run(&opt, body_rewind, &arg, "xsadd_rewind", label);
+    }
+    bench_end(&opt);
+    free(arg.key);
+    free(arg.streams);
+    return 0;
+}
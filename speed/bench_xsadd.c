@@ -0,0 +1,289 @@
+/**
+ * @file bench_xsadd.c
+ *
+ * @brief benchmark of the generation functions.
+ *
+ * Every output function of xsadd.h and xsadd_dist.h, the 8-lane
+ * generator, and the comparison variants xsadd_abcd and xsadd_indexed
+ * are measured. Bulk functions are measured with every kernel the CPU
+ * supports.
+ *
+ * Each benchmark is run once for warm up, then timed \b reps times
+ * generating \b count values, and the percentiles over the
+ * repetitions are reported in ns/value and cycles/value, see
+ * bench_common.h. Cycles are counted by rdtsc, so they are reference
+ * cycles, not core cycles under frequency scaling; they are not
+ * reported on other CPUs.
+ *
+ * Single value functions are measured in two modes.
+ * - throughput: the outputs are summed, and the next call does not
+ *   wait for the output.
+ * - latency: the address of the state of the next call depends on
+ *   the output, so the time is the latency from call to output.
+ *
+ * usage: bench_xsadd [-n count] [-r reps] [-f filter] [-o text|csv|json]
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include "bench_common.h"
+#include "xsadd.h"
+#include "xsadd_dist.h"
+#include "xsadd_abcd.h"
+#include "xsadd_indexed.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DEFAULT_COUNT 10000000
+#define BULK_SIZE 1000000
+#define ALIAS_SIZE 100
+#define BOUND 1000000
+
+/*
+ * a benchmark generates count values. The argument of single value
+ * benchmarks points to the latency flag.
+ */
+typedef struct {
+    const char * name;
+    const char * variant;
+    int bulk;
+    bench_body_t func;
+} bench_t;
+
+/*
+ * always 0, but the compiler does not know it.
+ */
+static volatile uint64_t zero_mask = 0;
+static uint32_t * bulk_u32;
+static float * bulk_float;
+static double * bulk_double;
+static xsadd_alias_t alias;
+
+/* =======================
+ * SINGLE VALUE BENCHMARKS
+   ======================= */
+static inline uint64_t float_bits(float x)
+{
+    uint32_t r;
+    memcpy(&r, &x, sizeof(r));
+    return r;
+}
+
+static inline uint64_t double_bits(double x)
+{
+    uint64_t r;
+    memcpy(&r, &x, sizeof(r));
+    return r;
+}
+
+static inline uint64_t u32_bits(uint32_t x)
+{
+    return x;
+}
+
+static inline uint32_t bounded(xsadd_t * xsadd)
+{
+    return xsadd_uint32_bounded(xsadd, BOUND);
+}
+
+static inline uint32_t alias_sample(xsadd_t * xsadd)
+{
+    return xsadd_alias_sample(xsadd, &alias);
+}
+
+static void pos_init(xsadd_pos_t * xsadd_pos, uint32_t seed)
+{
+    xsadd_pos_init(xsadd_pos, seed);
+}
+
+/*
+ * define single value benchmark fname, which calls call(state) count
+ * times. In latency mode the next state pointer depends on the
+ * output, which is converted to integer by bits.
+ */
+#define SINGLE_BENCH(fname, state_t, init, call, bits)			\
+    static uint64_t fname(void * arg, size_t count)			\
+    {									\
+	int latency = *(const int *)arg;				\
+	state_t st[1];							\
+	uint64_t sum = 0;						\
+	init(st, 1234);							\
+	if (latency) {							\
+	    state_t * p = st;						\
+	    uint64_t mask = zero_mask;					\
+	    for (size_t i = 0; i < count; i++) {			\
+		uint64_t r = bits(call(p));				\
+		sum += r;						\
+		p = st + (r & mask);					\
+	    }								\
+	} else {							\
+	    for (size_t i = 0; i < count; i++) {			\
+		sum += bits(call(st));					\
+	    }								\
+	}								\
+	return sum;							\
+    }
+
+SINGLE_BENCH(bench_uint32, xsadd_t, xsadd_init, xsadd_uint32, u32_bits)
+SINGLE_BENCH(bench_uint32_prev, xsadd_t, xsadd_init, xsadd_uint32_prev,
+	     u32_bits)
+SINGLE_BENCH(bench_float, xsadd_t, xsadd_init, xsadd_float, float_bits)
+SINGLE_BENCH(bench_floatOC, xsadd_t, xsadd_init, xsadd_floatOC, float_bits)
+SINGLE_BENCH(bench_double, xsadd_t, xsadd_init, xsadd_double, double_bits)
+SINGLE_BENCH(bench_doubleOC, xsadd_t, xsadd_init, xsadd_doubleOC,
+	     double_bits)
+SINGLE_BENCH(bench_bounded, xsadd_t, xsadd_init, bounded, u32_bits)
+SINGLE_BENCH(bench_pos_uint32, xsadd_pos_t, pos_init, xsadd_pos_uint32,
+	     u32_bits)
+SINGLE_BENCH(bench_normal, xsadd_t, xsadd_init, xsadd_normal, double_bits)
+SINGLE_BENCH(bench_exponential, xsadd_t, xsadd_init, xsadd_exponential,
+	     double_bits)
+SINGLE_BENCH(bench_alias_sample, xsadd_t, xsadd_init, alias_sample,
+	     u32_bits)
+SINGLE_BENCH(bench_abcd, xsadd_abcd_t, xsadd_abcd_init, xsadd_abcd_uint32,
+	     u32_bits)
+SINGLE_BENCH(bench_indexed, xsadd_indexed_t, xsadd_indexed_init,
+	     xsadd_indexed_uint32, u32_bits)
+
+/* ===============
+ * BULK BENCHMARKS
+   =============== */
+/*
+ * define bulk benchmark fname, which fills array by
+ * call(state, array, size) in blocks of BULK_SIZE.
+ */
+#define BULK_BENCH(fname, state_t, init, call, array)			\
+    static uint64_t fname(void * arg, size_t count)			\
+    {									\
+	state_t st;							\
+	uint64_t sum = 0;						\
+	(void)arg;							\
+	init(&st, 1234);						\
+	for (size_t i = 0; i < count; i += BULK_SIZE) {			\
+	    size_t size = count - i < BULK_SIZE ? count - i : BULK_SIZE; \
+	    call(&st, array, size);					\
+	    sum += array[size - 1];					\
+	}								\
+	return sum;							\
+    }
+
+static void fill_bounded(xsadd_t * xsadd, uint32_t array[], size_t size)
+{
+    xsadd_fill_bounded(xsadd, array, size, BOUND);
+}
+
+static void alias_fill(xsadd_t * xsadd, uint32_t array[], size_t size)
+{
+    xsadd_alias_fill(xsadd, &alias, array, size);
+}
+
+BULK_BENCH(bench_fill_uint32, xsadd_t, xsadd_init,
+	   xsadd_fill_array_uint32, bulk_u32)
+BULK_BENCH(bench_fill_uint32_reverse, xsadd_t, xsadd_init,
+	   xsadd_fill_array_uint32_reverse, bulk_u32)
+BULK_BENCH(bench_fill_float, xsadd_t, xsadd_init,
+	   xsadd_fill_array_float, bulk_float)
+BULK_BENCH(bench_fill_floatOC, xsadd_t, xsadd_init,
+	   xsadd_fill_array_floatOC, bulk_float)
+BULK_BENCH(bench_fill_double, xsadd_t, xsadd_init,
+	   xsadd_fill_array_double, bulk_double)
+BULK_BENCH(bench_fill_doubleOC, xsadd_t, xsadd_init,
+	   xsadd_fill_array_doubleOC, bulk_double)
+BULK_BENCH(bench_fill_bounded, xsadd_t, xsadd_init, fill_bounded, bulk_u32)
+BULK_BENCH(bench_fill8_uint32, xsadd8_t, xsadd8_init,
+	   xsadd8_fill_array_uint32, bulk_u32)
+BULK_BENCH(bench_fill_normal, xsadd_t, xsadd_init,
+	   xsadd_fill_array_normal, bulk_double)
+BULK_BENCH(bench_fill_exponential, xsadd_t, xsadd_init,
+	   xsadd_fill_array_exponential, bulk_double)
+BULK_BENCH(bench_alias_fill, xsadd_t, xsadd_init, alias_fill, bulk_u32)
+
+static const bench_t benches[] = {
+    {"xsadd_uint32", "xsadd", 0, bench_uint32},
+    {"xsadd_uint32_prev", "xsadd", 0, bench_uint32_prev},
+    {"xsadd_float", "xsadd", 0, bench_float},
+    {"xsadd_floatOC", "xsadd", 0, bench_floatOC},
+    {"xsadd_double", "xsadd", 0, bench_double},
+    {"xsadd_doubleOC", "xsadd", 0, bench_doubleOC},
+    {"xsadd_uint32_bounded", "xsadd", 0, bench_bounded},
+    {"xsadd_pos_uint32", "xsadd_pos", 0, bench_pos_uint32},
+    {"xsadd_normal", "xsadd", 0, bench_normal},
+    {"xsadd_exponential", "xsadd", 0, bench_exponential},
+    {"xsadd_alias_sample", "xsadd", 0, bench_alias_sample},
+    {"xsadd_uint32", "xsadd_abcd", 0, bench_abcd},
+    {"xsadd_uint32", "xsadd_indexed", 0, bench_indexed},
+    {"xsadd_fill_array_uint32", "xsadd", 1, bench_fill_uint32},
+    {"xsadd_fill_array_uint32_reverse", "xsadd", 1,
+     bench_fill_uint32_reverse},
+    {"xsadd_fill_array_float", "xsadd", 1, bench_fill_float},
+    {"xsadd_fill_array_floatOC", "xsadd", 1, bench_fill_floatOC},
+    {"xsadd_fill_array_double", "xsadd", 1, bench_fill_double},
+    {"xsadd_fill_array_doubleOC", "xsadd", 1, bench_fill_doubleOC},
+    {"xsadd_fill_bounded", "xsadd", 1, bench_fill_bounded},
+    {"xsadd8_fill_array_uint32", "xsadd8", 1, bench_fill8_uint32},
+    {"xsadd_fill_array_normal", "xsadd", 1, bench_fill_normal},
+    {"xsadd_fill_array_exponential", "xsadd", 1, bench_fill_exponential},
+    {"xsadd_alias_fill", "xsadd", 1, bench_alias_fill}
+};
+
+#define BENCH_COUNT (sizeof(benches) / sizeof(benches[0]))
+
+static const char * const kernel_names[] = {
+    "avx512", "avx2", "sse2", "generic"
+};
+
+#define KERNEL_NAME_COUNT (sizeof(kernel_names) / sizeof(kernel_names[0]))
+
+int main(int argc, char * argv[])
+{
+    bench_options_t opt;
+    double weights[ALIAS_SIZE];
+    int throughput = 0;
+    int latency = 1;
+    if (bench_parse_options(&opt, argc, argv, DEFAULT_COUNT) != 0
+	|| opt.count == 0) {
+	bench_usage(argv[0]);
+	return 1;
+    }
+    bulk_u32 = (uint32_t *)malloc(BULK_SIZE * sizeof(uint32_t));
+    bulk_float = (float *)malloc(BULK_SIZE * sizeof(float));
+    bulk_double = (double *)malloc(BULK_SIZE * sizeof(double));
+    for (int i = 0; i < ALIAS_SIZE; i++) {
+	weights[i] = i + 1;
+    }
+    if (bulk_u32 == NULL || bulk_float == NULL || bulk_double == NULL
+	|| xsadd_alias_init(&alias, weights, ALIAS_SIZE) != 0) {
+	printf("can't allocate memory\n");
+	return 1;
+    }
+    const char * default_kernel = xsadd_kernel_name();
+    bench_begin(&opt, default_kernel);
+    for (size_t i = 0; i < BENCH_COUNT; i++) {
+	const bench_t * b = &benches[i];
+	if (!bench_selected(&opt, b->name, b->variant)) {
+	    continue;
+	}
+	if (!b->bulk) {
+	    bench_run(&opt, b->func, &throughput, b->name, b->variant, "-",
+		      "throughput");
+	    bench_run(&opt, b->func, &latency, b->name, b->variant, "-",
+		      "latency");
+	    continue;
+	}
+	for (size_t k = 0; k < KERNEL_NAME_COUNT; k++) {
+	    if (xsadd_set_kernel(kernel_names[k]) == 0) {
+		bench_run(&opt, b->func, NULL, b->name, b->variant,
+			  kernel_names[k], "bulk");
+	    }
+	}
+	xsadd_set_kernel(default_kernel);
+    }
+    bench_end(&opt);
+    xsadd_alias_free(&alias);
+    free(bulk_u32);
+    free(bulk_float);
+    free(bulk_double);
+    return 0;
+}
@@ -1,7 +1,7 @@
 #include "xsadd_abcd.h"
 #define LOOP 8
 
-static void period_certification(xsadd_t * xsadd)
+static void period_certification(xsadd_abcd_t * xsadd)
 {
     if (xsadd->a == 0 &&
         xsadd->b == 0 &&
@@ -14,7 +14,7 @@ static void period_certification(xsadd_t * xsadd)
     }
 }
 
-void xsadd_init(xsadd_t * xsadd, uint32_t seed)
+void xsadd_abcd_init(xsadd_abcd_t * xsadd, uint32_t seed)
 {
     uint32_t state[4];
     state[0] = seed;
@@ -32,7 +32,7 @@ void xsadd_init(xsadd_t * xsadd, uint32_t seed)
     xsadd->d = state[3];
     period_certification(xsadd);
     for (int i = 0; i < LOOP; i++) {
-        xsadd_uint32(xsadd);
+        xsadd_abcd_uint32(xsadd);
     }
 }
 
@@ -28,11 +28,11 @@ extern "C" {
         uint32_t b;
         uint32_t c;
         uint32_t d;
-    } xsadd_t;
+    } xsadd_abcd_t;
 
-    void xsadd_init(xsadd_t * xsadd, uint32_t seed);
+    void xsadd_abcd_init(xsadd_abcd_t * xsadd, uint32_t seed);
 
-    static inline uint32_t xsadd_uint32(xsadd_t * xsadd)
+    static inline uint32_t xsadd_abcd_uint32(xsadd_abcd_t * xsadd)
     {
         static const int sh1 = 15;
         static const int sh2 = 18;
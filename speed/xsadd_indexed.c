@@ -21,7 +21,7 @@
 #include "xsadd_indexed.h"
 #define LOOP 8
 
-static void period_certification(xsadd_t * xsadd)
+static void period_certification(xsadd_indexed_t * xsadd)
 {
     if (xsadd->state[0] == 0 &&
         xsadd->state[0] == 0 &&
@@ -34,7 +34,7 @@ static void period_certification(xsadd_t * xsadd)
     }
 }
 
-void xsadd_init(xsadd_t * xsadd, uint32_t seed)
+void xsadd_indexed_init(xsadd_indexed_t * xsadd, uint32_t seed)
 {
     xsadd->state[0] = seed;
     xsadd->state[1] = 0;
@@ -48,7 +48,7 @@ void xsadd_init(xsadd_t * xsadd, uint32_t seed)
     xsadd->index = 3;
     period_certification(xsadd);
     for (int i = 0; i < LOOP; i++) {
-        xsadd_uint32(xsadd);
+        xsadd_indexed_uint32(xsadd);
     }
 }
 
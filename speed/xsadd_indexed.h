@@ -31,11 +31,11 @@ extern "C" {
     typedef struct {
         uint32_t state[4];
         int index;
-    } xsadd_t;
+    } xsadd_indexed_t;
 
-    void xsadd_init(xsadd_t * xsadd, uint32_t seed);
+    void xsadd_indexed_init(xsadd_indexed_t * xsadd, uint32_t seed);
 
-    static inline uint32_t xsadd_uint32(xsadd_t * xsadd)
+    static inline uint32_t xsadd_indexed_uint32(xsadd_indexed_t * xsadd)
     {
 #if defined(USE_MACRO_SHIFT)
 #define MASK 3
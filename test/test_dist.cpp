@@ -0,0 +1,331 @@
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <UnitTest++.h>
+#include "xsadd.h"
+#include "xsadd_dist.h"
+#include "xsadd.c"
+#include "xsadd_dist.c" // to check static functions
+
+using namespace std;
+
+// Fisher-Yates with two indices from each 32 or 64-bit output, one by
+// one
+static void shuffle_one_by_one(xsadd_t * xs, uint32_t a[], uint64_t m)
+{
+    for (; m > 2; m -= 2) {
+	uint64_t r1;
+	uint64_t r2;
+	if (m <= PAIR32_MAX) {
+	    while (pair32_rejected(xsadd_uint32(xs), (uint32_t)m,
+				   (uint32_t)m - 1, &r1, &r2)) {
+	    }
+	} else {
+	    while (pair_rejected(local_uint64(xs), m, m - 1, &r1, &r2)) {
+	    }
+	}
+	swap(a[m - 1], a[r1]);
+	swap(a[m - 2], a[r2]);
+    }
+    if (m == 2) {
+	swap(a[1], a[xsadd_uint32_bounded(xs, 2)]);
+    }
+}
+
+SUITE(DIST) {
+    TEST(TABLE)
+    {
+	// layer 0 is the base with the tail, the others are rectangles
+	// of the same area v
+	double v = NORMAL_R * normal_f[255] + sqrt(M_PI / 2)
+	    * erfc(NORMAL_R / sqrt(2.0));
+	for (int i = 1; i < 255; i++) {
+	    double x = normal_w[i] * 4503599627370496.0;
+	    CHECK_CLOSE(v, x * (normal_f[i - 1] - normal_f[i]), 1e-12);
+	    CHECK_CLOSE(exp(-0.5 * x * x), normal_f[i], 1e-15);
+	}
+	v = (EXP_R + 1) * exp_f[255];
+	for (int i = 1; i < 255; i++) {
+	    double x = exp_w[i] * 4503599627370496.0;
+	    CHECK_CLOSE(v, x * (exp_f[i - 1] - exp_f[i]), 1e-12);
+	    CHECK_CLOSE(exp(-x), exp_f[i], 1e-15);
+	}
+    }
+    TEST(MOMENTS)
+    {
+	xsadd_t xs;
+	const int size = 1000000;
+	double sum1 = 0;
+	double sum2 = 0;
+	double sum4 = 0;
+	int tail = 0;
+	xsadd_init(&xs, 1234);
+	for (int i = 0; i < size; i++) {
+	    double x = xsadd_normal(&xs);
+	    sum1 += x;
+	    sum2 += x * x;
+	    sum4 += x * x * x * x;
+	    if (fabs(x) > NORMAL_R) {
+		tail++;
+	    }
+	}
+	CHECK_CLOSE(0.0, sum1 / size, 0.005);
+	CHECK_CLOSE(1.0, sum2 / size, 0.005);
+	CHECK_CLOSE(3.0, sum4 / size, 0.05);
+	// 2 * (1 - Phi(r)) * size is about 258
+	CHECK(tail > 200 && tail < 320);
+	sum1 = 0;
+	sum2 = 0;
+	tail = 0;
+	for (int i = 0; i < size; i++) {
+	    double x = xsadd_exponential(&xs);
+	    CHECK(x >= 0);
+	    sum1 += x;
+	    sum2 += x * x;
+	    if (x > EXP_R) {
+		tail++;
+	    }
+	}
+	CHECK_CLOSE(1.0, sum1 / size, 0.005);
+	CHECK_CLOSE(2.0, sum2 / size, 0.02);
+	// exp(-r) * size is about 454
+	CHECK(tail > 380 && tail < 530);
+    }
+    TEST(FILL)
+    {
+	const char * names[] = {"avx512", "avx2", "sse2", "generic"};
+	const char * first = xsadd_kernel_name();
+	const size_t size = XSADD8_LANES * FILL_LANE_SIZE + 123;
+	vector<double> d(size);
+	for (int k = 0; k < 4; k++) {
+	    if (xsadd_set_kernel(names[k]) != 0) {
+		continue;
+	    }
+	    xsadd_t xs1;
+	    xsadd_t xs2;
+	    bool ok;
+	    xsadd_init(&xs1, 33);
+	    xsadd_init(&xs2, 33);
+	    for (size_t n = 0; n < 2000; n += 97) {
+		xsadd_fill_array_normal(&xs1, &d[0], n);
+		ok = true;
+		for (size_t i = 0; i < n; i++) {
+		    ok = ok && d[i] == xsadd_normal(&xs2);
+		}
+		CHECK(ok);
+		CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs1));
+	    }
+	    xsadd_fill_array_normal(&xs1, &d[0], size);
+	    ok = true;
+	    for (size_t i = 0; i < size; i++) {
+		ok = ok && d[i] == xsadd_normal(&xs2);
+	    }
+	    CHECK(ok);
+	    xsadd_fill_array_exponential(&xs1, &d[0], size);
+	    ok = true;
+	    for (size_t i = 0; i < size; i++) {
+		ok = ok && d[i] == xsadd_exponential(&xs2);
+	    }
+	    CHECK(ok);
+	    CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs1));
+	}
+	CHECK(xsadd_set_kernel(first) == 0);
+    }
+    TEST(ALIAS)
+    {
+	xsadd_alias_t alias;
+	double bad[3] = {1.0, -1.0, 2.0};
+	double zero[3] = {0.0, 0.0, 0.0};
+	CHECK_EQUAL(-1, xsadd_alias_init(&alias, bad, 3));
+	CHECK_EQUAL(-1, xsadd_alias_init(&alias, zero, 3));
+	CHECK_EQUAL(-1, xsadd_alias_init(&alias, bad, 0));
+	const uint32_t n = 1000;
+	vector<double> w(n);
+	xsadd_t xs;
+	xsadd_init(&xs, 1234);
+	double sum = 0;
+	for (uint32_t i = 0; i < n; i++) {
+	    // some categories have weight zero
+	    w[i] = (i % 7 == 3) ? 0.0 : xsadd_double(&xs) * (i % 5 + 1);
+	    sum += w[i];
+	}
+	CHECK_EQUAL(0, xsadd_alias_init(&alias, &w[0], n));
+	CHECK_EQUAL(n, alias.size);
+	// probabilities given by the table
+	vector<double> q(n, 0.0);
+	for (uint32_t i = 0; i < n; i++) {
+	    double p = alias.table[i].prob / 4294967296.0;
+	    CHECK(alias.table[i].alias < n);
+	    q[i] += p / n;
+	    q[alias.table[i].alias] += (1.0 - p) / n;
+	}
+	bool ok = true;
+	for (uint32_t i = 0; i < n; i++) {
+	    ok = ok && fabs(q[i] - w[i] / sum) < 1e-9;
+	}
+	CHECK(ok);
+	// same sequence as xsadd_alias_sample, and zero weight is never
+	// sampled
+	const size_t size = 300000;
+	vector<uint32_t> a(size);
+	xsadd_t xs2 = xs;
+	xsadd_alias_fill(&xs, &alias, &a[0], size);
+	vector<uint32_t> count(n, 0);
+	ok = true;
+	for (size_t i = 0; i < size; i++) {
+	    ok = ok && a[i] == xsadd_alias_sample(&xs2, &alias);
+	    count[a[i]]++;
+	}
+	CHECK(ok);
+	CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs));
+	double chi2 = 0;
+	int df = -1;
+	for (uint32_t i = 0; i < n; i++) {
+	    if (w[i] == 0) {
+		CHECK_EQUAL(0u, count[i]);
+		continue;
+	    }
+	    double e = size * w[i] / sum;
+	    chi2 += (count[i] - e) * (count[i] - e) / e;
+	    df++;
+	}
+	// chi-square of df about 856, mean df and sd sqrt(2 df)
+	CHECK(chi2 < df + 5 * sqrt(2.0 * df));
+	xsadd_alias_free(&alias);
+	CHECK(alias.table == NULL);
+	// subnormal sum, n / sum overflows
+	double tiny[2] = {0.0, 1e-320};
+	CHECK_EQUAL(0, xsadd_alias_init(&alias, tiny, 2));
+	ok = true;
+	for (int i = 0; i < 10000; i++) {
+	    ok = ok && xsadd_alias_sample(&xs, &alias) == 1;
+	}
+	CHECK(ok);
+	xsadd_alias_free(&alias);
+    }
+    TEST(BOUNDED_PAIR)
+    {
+	uint64_t lo;
+	CHECK_EQUAL(UINT64_C(0x0fffffffffffffff),
+		    mul128(&lo, UINT64_C(0xffffffffffffffff),
+			   UINT64_C(0x1000000000000000)));
+	CHECK_EQUAL(UINT64_C(0xf000000000000000), lo);
+	// outputs with 48 lower bits zero: 2^64 % (n1 n2) = 1, so only
+	// zero is rejected and the others give each pair exactly once.
+	vector<int> count(255 * 257, 0);
+	int rejected = 0;
+	for (uint64_t u = 0; u < 65536; u++) {
+	    uint64_t r1;
+	    uint64_t r2;
+	    if (pair_rejected(u << 48, 255, 257, &r1, &r2)) {
+		rejected++;
+		continue;
+	    }
+	    CHECK(r1 < 255 && r2 < 257);
+	    count[r1 * 257 + r2]++;
+	}
+	CHECK_EQUAL(1, rejected);
+	bool ok = true;
+	for (int i = 0; i < 255 * 257; i++) {
+	    ok = ok && count[i] == 1;
+	}
+	CHECK(ok);
+    }
+    TEST(SHUFFLE)
+    {
+	xsadd_t xs;
+	xsadd_init(&xs, 4321);
+	// permutation
+	const size_t size = SHUFFLE_BATCH_SIZE * 2 + 1001;
+	vector<uint32_t> a(size);
+	for (size_t i = 0; i < size; i++) {
+	    a[i] = (uint32_t)i;
+	}
+	xsadd_shuffle(&xs, &a[0], size);
+	vector<bool> seen(size, false);
+	bool ok = true;
+	size_t fixed = 0;
+	for (size_t i = 0; i < size; i++) {
+	    ok = ok && a[i] < size && !seen[a[i]];
+	    seen[a[i]] = true;
+	    if (a[i] == i) {
+		fixed++;
+	    }
+	}
+	CHECK(ok);
+	CHECK(fixed < 10);
+	// batches give the same result
+	xsadd_t xs2 = xs;
+	vector<uint32_t> b(a);
+	xsadd_shuffle(&xs, &a[0], size);
+	shuffle_one_by_one(&xs2, &b[0], size);
+	CHECK(a == b);
+	CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs));
+	// all 24 permutations of four elements are equally likely
+	const int count = 240000;
+	int freq[256] = {0};
+	for (int t = 0; t < count; t++) {
+	    uint32_t b[4] = {0, 1, 2, 3};
+	    xsadd_shuffle(&xs, b, 4);
+	    freq[b[0] * 64 + b[1] * 16 + b[2] * 4 + b[3]]++;
+	}
+	double chi2 = 0;
+	int perms = 0;
+	for (int i = 0; i < 256; i++) {
+	    if (freq[i] != 0) {
+		double e = count / 24.0;
+		chi2 += (freq[i] - e) * (freq[i] - e) / e;
+		perms++;
+	    }
+	}
+	CHECK_EQUAL(24, perms);
+	// 99.9 percentile of chi-square of 23 degrees of freedom
+	CHECK(chi2 < 49.73);
+	uint32_t one = 7;
+	xsadd_shuffle(&xs, &one, 1);
+	CHECK_EQUAL(7u, one);
+	xsadd_shuffle(&xs, NULL, 0);
+    }
+    TEST(RESERVOIR)
+    {
+	xsadd_t xs;
+	xsadd_init(&xs, 5555);
+	const size_t n = 3001;
+	const size_t k = 100;
+	vector<uint32_t> pop(n);
+	vector<uint32_t> sample(k);
+	for (size_t i = 0; i < n; i++) {
+	    pop[i] = (uint32_t)(i * 3);
+	}
+	CHECK_EQUAL(k, xsadd_reservoir_sample(&xs, &sample[0], k,
+					      &pop[0], n));
+	vector<int> freq(n, 0);
+	bool ok = true;
+	const int count = 3000;
+	for (int t = 0; t < count; t++) {
+	    xsadd_reservoir_sample(&xs, &sample[0], k, &pop[0], n);
+	    vector<bool> seen(n, false);
+	    for (size_t i = 0; i < k; i++) {
+		uint32_t j = sample[i] / 3;
+		ok = ok && sample[i] % 3 == 0 && j < n && !seen[j];
+		seen[j] = true;
+		freq[j]++;
+	    }
+	}
+	CHECK(ok);
+	// each element is selected with probability k / n
+	double chi2 = 0;
+	double e = (double)count * k / n;
+	for (size_t i = 0; i < n; i++) {
+	    chi2 += (freq[i] - e) * (freq[i] - e) / e;
+	}
+	CHECK(chi2 < n + 5 * sqrt(2.0 * n));
+	// population smaller than sample
+	CHECK_EQUAL(10u, xsadd_reservoir_sample(&xs, &sample[0], k,
+						&pop[0], 10));
+	for (size_t i = 0; i < 10; i++) {
+	    CHECK_EQUAL(pop[i], sample[i]);
+	}
+    }
+}
@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include <UnitTest++.h>
+#include <random>
+#include <sstream>
+#include "xsadd.hpp"
+#include "xsadd.c"
+
+using namespace std;
+
+/* evaluated at compile time, because they are constant expressions */
+static constexpr xsadd_jump_poly_t jump_2_64
+= xsadd_constexpr_jump_poly_u128(1, 0);
+static constexpr xsadd_jump_poly_t jump_all
+= xsadd_constexpr_jump_poly_u128(UINT64_MAX, UINT64_MAX);
+static constexpr xsadd_jump_poly_t jump_base_3
+= xsadd_constexpr_jump_poly(3, xsadd_constexpr_jump_base_step);
+static constexpr xsadd_jump_poly_t jump_lane
+= xsadd_constexpr_jump_poly(FILL_LANE_SIZE, "1");
+/* mul_step * base_step >= 2^128 is truncated as at run time */
+static constexpr xsadd_jump_poly_t jump_wrap
+= xsadd_constexpr_jump_poly(0xffffffffU, "ffffffffffffffffffffffffffffffff");
+static_assert(jump_wrap.poly[0] == UINT64_C(0x975e8b1e26710e8f)
+	      && jump_wrap.poly[1] == UINT64_C(0x5ebd6ce9d29c13b0),
+	      "constexpr jump polynomial is not truncated");
+/* digits after the first 32 are ignored as at run time */
+static constexpr xsadd_jump_poly_t jump_long
+= xsadd_constexpr_jump_poly(7, "123456789abcdef0123456789abcdef0123");
+/* the value of fill_lane_jump in xsadd.c */
+static_assert(jump_lane.poly[0] == UINT64_C(0x15e75f3b4b18364c)
+	      && jump_lane.poly[1] == UINT64_C(0x16e09e09f5e1cc72),
+	      "constexpr jump polynomial is wrong");
+
+static bool poly_eq(const xsadd_jump_poly_t& x, const xsadd_jump_poly_t& y)
+{
+    return x.poly[0] == y.poly[0] && x.poly[1] == y.poly[1];
+}
+
+SUITE(ENGINE) {
+    TEST(UINT32)
+    {
+	xsadd_engine engine(1234);
+	xsadd_t xs;
+	xsadd_init(&xs, 1234);
+	for (int i = 0; i < 1000; i++) {
+	    CHECK_EQUAL(xsadd_uint32(&xs), engine());
+	}
+	CHECK_EQUAL(0u, xsadd_engine::min());
+	CHECK_EQUAL(UINT32_MAX, xsadd_engine::max());
+    }
+    TEST(UINT64)
+    {
+	xsadd_engine64 engine(1234);
+	xsadd_t xs;
+	xsadd_init(&xs, 1234);
+	for (int i = 0; i < 1000; i++) {
+	    uint64_t hi = xsadd_uint32(&xs);
+	    uint64_t lo = xsadd_uint32(&xs);
+	    CHECK_EQUAL((hi << 32) | lo, engine());
+	}
+	CHECK_EQUAL(UINT64_MAX, xsadd_engine64::max());
+    }
+    TEST(DISCARD)
+    {
+	xsadd_engine e1;
+	xsadd_engine e2;
+	xsadd_engine64 f1;
+	xsadd_engine64 f2;
+	for (unsigned long long z = 0; z < 3000; z += 123) {
+	    e1.discard(z);
+	    for (unsigned long long i = 0; i < z; i++) {
+		e2();
+	    }
+	    CHECK(e1 == e2);
+	    f1.discard(z);
+	    for (unsigned long long i = 0; i < z; i++) {
+		f2();
+	    }
+	    CHECK(f1 == f2);
+	}
+	e1();
+	CHECK(e1 != e2);
+    }
+    TEST(SEED)
+    {
+	xsadd_engine e1;
+	xsadd_engine e2(xsadd_engine::default_seed);
+	CHECK(e1 == e2);
+	e1.seed(5);
+	e2.seed(5);
+	CHECK(e1 == e2);
+	seed_seq seq1{1, 2, 3};
+	seed_seq seq2{1, 2, 3};
+	xsadd_engine e3(seq1);
+	e2.seed(seq2);
+	CHECK(e3 == e2);
+	CHECK(e3 != e1);
+    }
+    TEST(STATE)
+    {
+	xsadd_t xs;
+	xsadd_init(&xs, 5);
+	xsadd_engine e1(xs);
+	const xsadd_t& cxs = xs;
+	xsadd_engine e2(cxs);
+	for (int i = 0; i < 1000; i++) {
+	    uint32_t r = xsadd_uint32(&xs);
+	    CHECK_EQUAL(r, e1());
+	    CHECK_EQUAL(r, e2());
+	}
+    }
+    TEST(STREAM)
+    {
+	xsadd_engine64 e1(99);
+	xsadd_engine64 e2;
+	e1.discard(10);
+	stringstream ss;
+	ss << e1;
+	ss >> e2;
+	CHECK(!ss.fail());
+	CHECK(e1 == e2);
+	CHECK_EQUAL(e1(), e2());
+	stringstream zero("0 0 0 0");
+	xsadd_engine64 e3 = e2;
+	zero >> e3;
+	CHECK(zero.fail());
+	CHECK(e3 == e2);
+    }
+    TEST(DISTRIBUTION)
+    {
+	xsadd_engine64 engine(1);
+	uniform_real_distribution<double> dist(0.0, 1.0);
+	double sum = 0;
+	for (int i = 0; i < 10000; i++) {
+	    double x = dist(engine);
+	    CHECK(x >= 0.0 && x < 1.0);
+	    sum += x;
+	}
+	CHECK_CLOSE(0.5, sum / 10000, 0.02);
+    }
+    TEST(CONSTEXPR_JUMP)
+    {
+	xsadd_jump_poly_t poly;
+	xsadd_calculate_jump_poly_u128(&poly, 1, 0);
+	CHECK(poly_eq(poly, jump_2_64));
+	xsadd_calculate_jump_poly_u128(&poly, UINT64_MAX, UINT64_MAX);
+	CHECK(poly_eq(poly, jump_all));
+	xsadd_calculate_jump_poly(&poly, 3, xsadd_jump_base_step);
+	CHECK(poly_eq(poly, jump_base_3));
+	CHECK(poly_eq(fill_lane_jump, jump_lane));
+	xsadd_calculate_jump_poly(&poly, 0xffffffffU,
+				  "ffffffffffffffffffffffffffffffff");
+	CHECK(poly_eq(poly, jump_wrap));
+	xsadd_calculate_jump_poly(&poly, 7,
+				  "123456789abcdef0123456789abcdef0123");
+	CHECK(poly_eq(poly, jump_long));
+	const uint32_t muls[] = {2, 1000, 0x80000001U, 0xffffffffU};
+	for (size_t i = 0; i < sizeof(muls) / sizeof(muls[0]); i++) {
+	    xsadd_calculate_jump_poly(&poly, muls[i],
+				      "fedcba9876543210fedcba9876543210");
+	    CHECK(poly_eq(poly, xsadd_constexpr_jump_poly(
+			      muls[i], "fedcba9876543210fedcba9876543210")));
+	}
+	const uint64_t steps[] = {0, 1, 127, 128, 1000, UINT64_C(1) << 63};
+	for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+	    xsadd_calculate_jump_poly_u128(&poly, 0, steps[i]);
+	    CHECK(poly_eq(poly, xsadd_constexpr_jump_poly_u128(0, steps[i])));
+	}
+	xsadd_t xs1;
+	xsadd_t xs2;
+	xsadd_init(&xs1, 1234);
+	xsadd_init(&xs2, 1234);
+	xsadd_jump(&xs1, 3, xsadd_jump_base_step);
+	xsadd_jump_by_poly(&xs2, &jump_base_3);
+	for (int i = 0; i < 4; i++) {
+	    CHECK_EQUAL(xs1.state[i], xs2.state[i]);
+	}
+    }
+}
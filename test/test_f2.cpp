@@ -148,6 +148,34 @@ SUITE(F2POLYNOMIAL) {
 	    }
 	}
     }
+    TEST(CLMUL)
+    {
+	GF2X p;
+	GF2X q;
+	GF2X r;
+	f2_polynomial p2;
+	f2_polynomial q2;
+	f2_polynomial r2;
+	uint64_t a[4];
+	uint64_t b[4];
+	uint64_t c[4];
+	uint64_t d[4];
+	for (int i = 0; i < 100; i++) {
+	    random(p, POLYNOMIAL_ARRAY_SIZE * 16);
+	    random(q, POLYNOMIAL_ARRAY_SIZE * 16);
+	    r = p * q;
+	    tof2(p2, p);
+	    tof2(q2, q);
+	    tof2(r2, r);
+	    to64(a, &p2);
+	    to64(b, &q2);
+	    to64(d, &r2);
+	    clmul128_generic(c, a, b);
+	    CHECK(c[0] == d[0] && c[1] == d[1] && c[2] == d[2] && c[3] == d[3]);
+	    clmul128(c, a, b);
+	    CHECK(c[0] == d[0] && c[1] == d[1] && c[2] == d[2] && c[3] == d[3]);
+	}
+    }
     TEST(MOD)
     {
 	GF2X p;
@@ -228,6 +256,58 @@ SUITE(F2POLYNOMIAL) {
 	    }
 	}
     }
+    TEST(MODPHI)
+    {
+	GF2X p;
+	f2_polynomial p2;
+	f2_polynomial ch2;
+	f2_poly128 r;
+	uint64_t a[4];
+	strtopolynomial(&ch2, characteristic_polynomial);
+	for (int i = 0; i < 100; i++) {
+	    random(p, POLYNOMIAL_ARRAY_SIZE * 32 - 1);
+	    tof2(p2, p);
+	    to64(a, &p2);
+	    mod_phi(&r, a);
+	    mod(&p2, &ch2);
+	    to64(a, &p2);
+	    CHECK(r.ar[0] == a[0] && r.ar[1] == a[1] && a[2] == 0 && a[3] == 0);
+	}
+    }
+    TEST(POWERMODPHI)
+    {
+	ZZ x;
+	uz x2;
+	f2_polynomial p2;
+	f2_polynomial ch2;
+	f2_polynomial r2;
+	f2_poly128 r;
+	uint64_t a[4];
+	strtopolynomial(&ch2, characteristic_polynomial);
+	clear(&p2);
+	p2.ar[0] = 2;
+	for (int i = 0; i < 100; i++) {
+	    RandomBits(x, UZ_ARRAY_SIZE * 16);
+	    touz(&x2, x);
+	    polynomial_power_mod(&r2, &p2, &x2, &ch2);
+	    power_mod_phi(&r, &x2);
+	    to64(a, &r2);
+	    CHECK(r.ar[0] == a[0] && r.ar[1] == a[1]);
+	}
+    }
+    TEST(JUMPTABLE)
+    {
+	f2_poly128 x;
+	x.ar[0] = 2;
+	x.ar[1] = 0;
+	for (int i = 0; i < 128; i++) {
+	    CHECK(x.ar[0] == jump_table[i].ar[0]
+		  && x.ar[1] == jump_table[i].ar[1]);
+	    square_mod_phi(&x);
+	}
+	// t^(2^128) = t, because the period is 2^128 - 1
+	CHECK(x.ar[0] == 2 && x.ar[1] == 0);
+    }
     TEST(POWERMOD2)
     {
 	ZZ step;
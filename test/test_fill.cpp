@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <vector>
+#include <UnitTest++.h>
+#include "xsadd.h"
+#include "xsadd.c"
+
+using namespace std;
+
+SUITE(FILL) {
+    TEST(UINT32)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	uint32_t array[1003];
+	for (int size = 0; size < 1003; size += 59) {
+	    xsadd_init(&xs1, 1234 + size);
+	    xsadd_init(&xs2, 1234 + size);
+	    xsadd_fill_array_uint32(&xs1, array, size);
+	    for (int i = 0; i < size; i++) {
+		CHECK_EQUAL(xsadd_uint32(&xs2), array[i]);
+	    }
+	    CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs1));
+	}
+    }
+    TEST(FLOAT)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	float array[1003];
+	xsadd_init(&xs1, 4321);
+	xsadd_init(&xs2, 4321);
+	xsadd_fill_array_float(&xs1, array, 1003);
+	for (int i = 0; i < 1003; i++) {
+	    CHECK_EQUAL(xsadd_float(&xs2), array[i]);
+	}
+	CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs1));
+    }
+    TEST(DOUBLE)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	double array[1003];
+	xsadd_init(&xs1, 5678);
+	xsadd_init(&xs2, 5678);
+	xsadd_fill_array_double(&xs1, array, 1003);
+	for (int i = 0; i < 1003; i++) {
+	    CHECK_EQUAL(xsadd_double(&xs2), array[i]);
+	}
+	CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs1));
+    }
+    TEST(XSADD8)
+    {
+	xsadd8_t xs8;
+	xsadd_t xs[XSADD8_LANES];
+	xsadd_t tmp;
+	uint32_t array[XSADD8_LANES * 131];
+	xsadd8_init(&xs8, 1234);
+	xsadd_init(&tmp, 1234);
+	for (int j = 0; j < XSADD8_LANES; j++) {
+	    xs[j] = tmp;
+	    xsadd_jump(&tmp, 1, xsadd_jump_base_step);
+	}
+	xsadd8_fill_array_uint32(&xs8, array, XSADD8_LANES * 131);
+	for (int i = 0; i < 131; i++) {
+	    for (int j = 0; j < XSADD8_LANES; j++) {
+		CHECK_EQUAL(xsadd_uint32(&xs[j]), array[i * XSADD8_LANES + j]);
+	    }
+	}
+	xsadd8_uint32(&xs8, array);
+	for (int j = 0; j < XSADD8_LANES; j++) {
+	    CHECK_EQUAL(xsadd_uint32(&xs[j]), array[j]);
+	    xsadd8_get_lane(&tmp, &xs8, j);
+	    for (int i = 0; i < 4; i++) {
+		CHECK_EQUAL(xs[j].state[i], tmp.state[i]);
+	    }
+	}
+    }
+    TEST(KERNEL)
+    {
+	const char * names[] = {"avx512", "avx2", "sse2", "generic"};
+	const char * first = xsadd_kernel_name();
+	xsadd8_t ref;
+	uint32_t expected[XSADD8_LANES * 50];
+	uint32_t array[XSADD8_LANES * 50];
+	xsadd8_init(&ref, 4321);
+	for (int i = 0; i < 50; i++) {
+	    xsadd8_uint32(&ref, &expected[i * XSADD8_LANES]);
+	}
+	for (int k = 0; k < 4; k++) {
+	    if (xsadd_set_kernel(names[k]) != 0) {
+		continue;
+	    }
+	    xsadd8_t xs8;
+	    xsadd8_init(&xs8, 4321);
+	    xsadd8_fill_array_uint32(&xs8, array, XSADD8_LANES * 50);
+	    for (int i = 0; i < XSADD8_LANES * 50; i++) {
+		CHECK_EQUAL(expected[i], array[i]);
+	    }
+	}
+	CHECK(xsadd_set_kernel("generic") == 0);
+	CHECK(xsadd_set_kernel("unknown") != 0);
+	CHECK(xsadd_set_kernel(first) == 0);
+    }
+    TEST(KERNEL_SINGLE_STREAM)
+    {
+	const char * names[] = {"avx512", "avx2", "sse2", "generic"};
+	const char * first = xsadd_kernel_name();
+	const size_t size = 2 * XSADD8_LANES * FILL_LANE_SIZE + 123;
+	vector<uint32_t> expected(size);
+	vector<uint32_t> array(size);
+	xsadd_t ref;
+	xsadd_init(&ref, 1234);
+	for (size_t i = 0; i < size; i++) {
+	    expected[i] = xsadd_uint32(&ref);
+	}
+	for (int k = 0; k < 4; k++) {
+	    if (xsadd_set_kernel(names[k]) != 0) {
+		continue;
+	    }
+	    xsadd_t xs;
+	    xsadd_init(&xs, 1234);
+	    xsadd_fill_array_uint32(&xs, &array[0], size);
+	    CHECK(expected == array);
+	    for (int i = 0; i < 4; i++) {
+		CHECK_EQUAL(ref.state[i], xs.state[i]);
+	    }
+	}
+	CHECK(xsadd_set_kernel(first) == 0);
+    }
+    TEST(KERNEL_REAL)
+    {
+	const char * names[] = {"avx512", "avx2", "sse2", "generic"};
+	const char * first = xsadd_kernel_name();
+	const size_t size = XSADD8_LANES * FILL_LANE_SIZE + 123;
+	vector<float> f(size);
+	vector<double> d(size);
+	for (int k = 0; k < 4; k++) {
+	    if (xsadd_set_kernel(names[k]) != 0) {
+		continue;
+	    }
+	    xsadd_t xs1;
+	    xsadd_t xs2;
+	    bool ok;
+	    xsadd_init(&xs1, 11);
+	    xsadd_init(&xs2, 11);
+	    xsadd_fill_array_float(&xs1, &f[0], size);
+	    ok = true;
+	    for (size_t i = 0; i < size; i++) {
+		ok = ok && f[i] == xsadd_float(&xs2);
+	    }
+	    CHECK(ok);
+	    xsadd_fill_array_floatOC(&xs1, &f[0], size);
+	    ok = true;
+	    for (size_t i = 0; i < size; i++) {
+		ok = ok && f[i] == xsadd_floatOC(&xs2) && f[i] > 0.0f;
+	    }
+	    CHECK(ok);
+	    xsadd_fill_array_double(&xs1, &d[0], size);
+	    ok = true;
+	    for (size_t i = 0; i < size; i++) {
+		ok = ok && d[i] == xsadd_double(&xs2);
+	    }
+	    CHECK(ok);
+	    xsadd_fill_array_doubleOC(&xs1, &d[0], size);
+	    ok = true;
+	    for (size_t i = 0; i < size; i++) {
+		ok = ok && d[i] == xsadd_doubleOC(&xs2) && d[i] > 0.0;
+	    }
+	    CHECK(ok);
+	    CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs1));
+	}
+	CHECK(xsadd_set_kernel(first) == 0);
+    }
+    TEST(BOUNDED)
+    {
+	const char * names[] = {"avx512", "avx2", "sse2", "generic"};
+	const char * first = xsadd_kernel_name();
+	const uint32_t bounds[] = {1, 3, 1000, 0x10000, 0x80000001u,
+				   0xffffffffu};
+	const size_t size = XSADD8_LANES * FILL_LANE_SIZE + 123;
+	vector<uint32_t> array(size);
+	for (int k = 0; k < 4; k++) {
+	    if (xsadd_set_kernel(names[k]) != 0) {
+		continue;
+	    }
+	    for (int b = 0; b < 6; b++) {
+		uint32_t n = bounds[b];
+		xsadd_t xs1;
+		xsadd_t xs2;
+		bool ok = true;
+		xsadd_init(&xs1, n);
+		xsadd_init(&xs2, n);
+		xsadd_fill_bounded(&xs1, &array[0], size, n);
+		for (size_t i = 0; i < size; i++) {
+		    ok = ok && array[i] < n
+			&& array[i] == xsadd_uint32_bounded(&xs2, n);
+		}
+		CHECK(ok);
+		CHECK_EQUAL(xsadd_uint32(&xs2), xsadd_uint32(&xs1));
+	    }
+	}
+	CHECK(xsadd_set_kernel(first) == 0);
+    }
+}
@@ -3,6 +3,7 @@
 #include <UnitTest++.h>
 #include <tr1/random>
 #include <sstream>
+#include <algorithm>
 #include "xsadd.h"
 #include "xsadd.c" // to check static functions
 
@@ -62,6 +63,24 @@ bool eq(xsadd_t& xs1, xsadd_t& xs2)
     return true;
 }
 
+/* straightforward jump by polynomial, for comparison */
+void jump_reference(xsadd_t * xsadd, const f2_polynomial * jump_poly)
+{
+    xsadd_t work;
+    for (int i = 0; i < 4; i++) {
+	work.state[i] = 0;
+    }
+    for (int i = 0; i < POLYNOMIAL_ARRAY_SIZE; i++) {
+	for (int j = 0; j < 32; j++) {
+	    if ((jump_poly->ar[i] >> j) & 1) {
+		xsadd_add(&work, xsadd);
+	    }
+	    xsadd_next_state(xsadd);
+	}
+    }
+    *xsadd = work;
+}
+
 SUITE(JUMP) {
     TEST(SMALL)
     {
@@ -101,4 +120,220 @@ SUITE(JUMP) {
 	    CHECK(eq(xs1, xs2));
 	}
     }
+    TEST(POLYNOMIAL)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	f2_polynomial poly;
+	tr1::mt19937 mt(1);
+	for (int i = 0; i < 200; i++) {
+	    uint32_t seed = mt();
+	    int size = i % (POLYNOMIAL_ARRAY_SIZE + 1);
+	    clear(&poly);
+	    for (int j = 0; j < size; j++) {
+		poly.ar[j] = mt();
+	    }
+	    xsadd_init(&xs1, seed);
+	    xsadd_init(&xs2, seed);
+	    jump_by_f2(&xs1, &poly);
+	    jump_reference(&xs2, &poly);
+	    CHECK(eq(xs1, xs2));
+	}
+    }
+    TEST(BINARY)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	xsadd_jump_poly_t jump_poly;
+	xsadd_jump_poly_t jump_poly2;
+	tr1::mt19937 mt(1);
+	char buff[200];
+	char str[200];
+	for (int i = 0; i < 200; i++) {
+	    uint32_t seed = mt();
+	    uint32_t step = mt();
+	    ZZ lstep;
+	    RandomBits(lstep, 70);
+	    to16string(buff, lstep);
+	    xsadd_init(&xs1, seed);
+	    xsadd_init(&xs2, seed);
+	    xsadd_calculate_jump_poly(&jump_poly, step, buff);
+	    xsadd_jump_by_poly(&xs1, &jump_poly);
+	    xsadd_jump(&xs2, step, buff);
+	    CHECK(eq(xs1, xs2));
+	    xsadd_calculate_jump_polynomial(str, step, buff);
+	    xsadd_jump_poly_to_str(buff, &jump_poly);
+	    CHECK_EQUAL(str, buff);
+	    xsadd_jump_poly_from_str(&jump_poly2, str);
+	    CHECK_EQUAL(jump_poly.poly[0], jump_poly2.poly[0]);
+	    CHECK_EQUAL(jump_poly.poly[1], jump_poly2.poly[1]);
+	}
+	// t^128 is reduced modulo the characteristic polynomial
+	xsadd_jump_poly_from_str(&jump_poly,
+				 "100000000000000000000000000000000");
+	xsadd_init(&xs1, 1234);
+	xsadd_init(&xs2, 1234);
+	xsadd_jump_by_poly(&xs1, &jump_poly);
+	for (int j = 0; j < 128; j++) {
+	    xsadd_uint32(&xs2);
+	}
+	CHECK(eq(xs1, xs2));
+    }
+    TEST(U128)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	tr1::mt19937 mt(1);
+	char buff[200];
+	for (int i = 0; i < 200; i++) {
+	    uint32_t seed = mt();
+	    ZZ lstep;
+	    RandomBits(lstep, 128);
+	    to16string(buff, lstep);
+	    uint64_t hi = 0;
+	    uint64_t lo = 0;
+	    for (int j = 0; j < 64; j++) {
+		lo |= (uint64_t)bit(lstep, j) << j;
+		hi |= (uint64_t)bit(lstep, j + 64) << j;
+	    }
+	    xsadd_init(&xs1, seed);
+	    xsadd_init(&xs2, seed);
+	    xsadd_jump_u128(&xs1, hi, lo);
+	    xsadd_jump(&xs2, 1, buff);
+	    CHECK(eq(xs1, xs2));
+	}
+    }
+    TEST(DISCARD)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	tr1::mt19937 mt(1);
+	for (int i = 0; i < 200; i++) {
+	    uint32_t seed = mt();
+	    uint64_t step = mt() % (4 * DISCARD_JUMP_THRESHOLD);
+	    xsadd_init(&xs1, seed);
+	    xsadd_init(&xs2, seed);
+	    xsadd_discard(&xs1, step);
+	    for (uint64_t j = 0; j < step; j++) {
+		xsadd_uint32(&xs2);
+	    }
+	    CHECK(eq(xs1, xs2));
+	}
+    }
+    TEST(SEEK)
+    {
+	xsadd_pos_t xp;
+	xsadd_t xs;
+	uint64_t hi;
+	uint64_t lo;
+	uint32_t array[3000];
+	tr1::mt19937 mt(1);
+	xsadd_init(&xs, 1234);
+	for (int i = 0; i < 3000; i++) {
+	    array[i] = xsadd_uint32(&xs);
+	}
+	xsadd_pos_init(&xp, 1234);
+	for (int i = 0; i < 200; i++) {
+	    uint64_t pos = mt() % 2000;
+	    xsadd_seek(&xp, 0, pos);
+	    xsadd_tell(&xp, &hi, &lo);
+	    CHECK_EQUAL(0u, hi);
+	    CHECK_EQUAL(pos, lo);
+	    for (int j = 0; j < 10; j++) {
+		CHECK_EQUAL(array[pos + j], xsadd_pos_uint32(&xp));
+	    }
+	    xsadd_tell(&xp, &hi, &lo);
+	    CHECK_EQUAL(pos + 10, lo);
+	}
+	// large position, forward and backward
+	xsadd_init(&xs, 1234);
+	xsadd_jump_u128(&xs, 5, 7);
+	uint32_t r = xsadd_uint32(&xs);
+	xsadd_seek(&xp, 5, 7);
+	CHECK_EQUAL(r, xsadd_pos_uint32(&xp));
+	xsadd_seek(&xp, 0, 2);
+	CHECK_EQUAL(array[2], xsadd_pos_uint32(&xp));
+	xsadd_seek(&xp, 5, 7);
+	CHECK_EQUAL(r, xsadd_pos_uint32(&xp));
+    }
+    TEST(AT)
+    {
+	xsadd_t xs;
+	xsadd_t xs2;
+	uint32_t array[3000];
+	uint64_t index[300];
+	uint32_t out[300];
+	tr1::mt19937 mt(1);
+	xsadd_init(&xs, 4321);
+	xs2 = xs;
+	for (int i = 0; i < 3000; i++) {
+	    array[i] = xsadd_uint32(&xs2);
+	}
+	for (int i = 0; i < 100; i++) {
+	    uint64_t pos = mt() % 3000;
+	    CHECK_EQUAL(array[pos], xsadd_at(&xs, pos));
+	}
+	// sorted with duplicates, then unsorted
+	for (int i = 0; i < 300; i++) {
+	    index[i] = mt() % 3000;
+	}
+	sort(index, index + 200);
+	index[100] = index[99];
+	xsadd_at_many(&xs, out, index, 300);
+	for (int i = 0; i < 300; i++) {
+	    CHECK_EQUAL(array[index[i]], out[i]);
+	}
+	// large index
+	xs2 = xs;
+	xsadd_jump_u128(&xs2, 0, UINT64_C(0xffffffffffffffff));
+	uint32_t last = xsadd_uint32(&xs2);
+	index[0] = 5;
+	index[1] = UINT64_C(1) << 40;
+	index[2] = UINT64_C(0xffffffffffffffff);
+	index[3] = 7;
+	xsadd_at_many(&xs, out, index, 4);
+	CHECK_EQUAL(array[5], out[0]);
+	CHECK_EQUAL(xsadd_at(&xs, index[1]), out[1]);
+	CHECK_EQUAL(last, out[2]);
+	CHECK_EQUAL(last, xsadd_at(&xs, index[2]));
+	CHECK_EQUAL(array[7], out[3]);
+    }
+    TEST(BACKWARD)
+    {
+	xsadd_t xs1;
+	xsadd_t xs2;
+	tr1::mt19937 mt(1);
+	uint32_t array1[2000];
+	uint32_t array2[2000];
+	for (int i = 0; i < 200; i++) {
+	    uint32_t seed = mt();
+	    uint64_t hi = mt() % 3;
+	    uint64_t lo = mt();
+	    xsadd_init(&xs1, seed);
+	    xsadd_init(&xs2, seed);
+	    xsadd_uint32(&xs2);
+	    xsadd_prev_state(&xs2);
+	    CHECK(eq(xs1, xs2));
+	    xsadd_jump_u128(&xs2, hi, lo);
+	    xsadd_jump_back_u128(&xs2, hi, lo);
+	    CHECK(eq(xs1, xs2));
+	    uint32_t step = mt() % (4 * REWIND_JUMP_THRESHOLD);
+	    xsadd_discard(&xs2, step);
+	    xsadd_rewind(&xs2, step);
+	    CHECK(eq(xs1, xs2));
+	}
+	for (int size = 1; size <= 2000; size += 333) {
+	    xsadd_init(&xs1, 1234);
+	    for (int i = 0; i < size; i++) {
+		array1[i] = xsadd_uint32(&xs1);
+	    }
+	    xsadd_fill_array_uint32_reverse(&xs1, array2, size);
+	    for (int i = 0; i < size; i++) {
+		CHECK_EQUAL(array1[size - 1 - i], array2[i]);
+	    }
+	    xsadd_init(&xs2, 1234);
+	    CHECK(eq(xs1, xs2));
+	    CHECK_EQUAL(array1[0], xsadd_uint32(&xs1));
+	}
+    }
 }
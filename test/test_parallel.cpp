@@ -0,0 +1,152 @@
+#include <stdint.h>
+#include <limits.h>
+#include <UnitTest++.h>
+#include <tr1/random>
+#include <vector>
+#include "xsadd.h"
+#include "xsadd.c" // to check static functions
+#include "xsadd_parallel.c"
+
+using namespace std;
+
+struct thread_local_result {
+    uint64_t index;
+    xsadd_t state;
+    bool same_pointer;
+};
+
+static void * thread_local_run(void * arg)
+{
+    thread_local_result * r = static_cast<thread_local_result *>(arg);
+    xsadd_t * xsadd = xsadd_thread_local();
+    r->state = *xsadd;
+    r->index = xsadd_thread_local_index();
+    xsadd_uint32(xsadd);
+    r->same_pointer = xsadd_thread_local() == xsadd;
+    return NULL;
+}
+
+static bool eq(const xsadd_t& xs1, const xsadd_t& xs2)
+{
+    for (int i = 0; i < 4; i++) {
+	if (xs1.state[i] != xs2.state[i]) {
+	    return false;
+	}
+    }
+    return true;
+}
+
+SUITE(PARALLEL) {
+    TEST(POLY_MUL_POW)
+    {
+	xsadd_jump_poly_t x;
+	xsadd_jump_poly_t y;
+	xsadd_jump_poly_t z;
+	xsadd_jump_poly_t w;
+	tr1::mt19937 mt(1);
+	for (int i = 0; i < 100; i++) {
+	    uint64_t a = mt();
+	    uint64_t b = mt();
+	    uint32_t e = mt() % 1000;
+	    xsadd_calculate_jump_poly_u128(&x, 0, a);
+	    xsadd_calculate_jump_poly_u128(&y, 0, b);
+	    xsadd_jump_poly_mul(&z, &x, &y);
+	    xsadd_calculate_jump_poly_u128(&w, 0, a + b);
+	    CHECK_EQUAL(w.poly[0], z.poly[0]);
+	    CHECK_EQUAL(w.poly[1], z.poly[1]);
+	    xsadd_jump_poly_pow(&z, &x, e);
+	    xsadd_calculate_jump_poly_u128(&w, 0, a * e);
+	    CHECK_EQUAL(w.poly[0], z.poly[0]);
+	    CHECK_EQUAL(w.poly[1], z.poly[1]);
+	}
+    }
+    TEST(SPAWN)
+    {
+	xsadd_t root;
+	xsadd_t work;
+	const size_t n = 1000;
+	vector<xsadd_t> out(n);
+	xsadd_init(&root, 1234);
+	xsadd_spawn_streams(&root, &out[0], n, 1, 12345);
+	work = root;
+	for (size_t i = 0; i < n; i++) {
+	    CHECK(eq(work, out[i]));
+	    xsadd_jump_u128(&work, 1, 12345);
+	}
+    }
+    TEST(SPAWN_PARALLEL)
+    {
+	xsadd_t root;
+	const size_t n = 1001;
+	vector<xsadd_t> out1(n);
+	vector<xsadd_t> out2(n);
+	xsadd_init(&root, 4321);
+	xsadd_spawn_streams(&root, &out1[0], n, 0, 99999);
+	const int nthreads[] = {-1, 0, 1, 2, 3, 4, 5, 1000, INT_MIN};
+	for (size_t k = 0; k < sizeof(nthreads) / sizeof(nthreads[0]); k++) {
+	    xsadd_spawn_streams_parallel(&root, &out2[0], n, 0, 99999,
+					 nthreads[k]);
+	    for (size_t i = 0; i < n; i++) {
+		CHECK(eq(out1[i], out2[i]));
+	    }
+	}
+	xsadd_spawn_streams_parallel(&root, &out2[0], 3, 0, 99999, 8);
+	for (size_t i = 0; i < 3; i++) {
+	    CHECK(eq(out1[i], out2[i]));
+	}
+    }
+    TEST(PARALLEL_FILL)
+    {
+	const size_t sizes[] = {0, 1, 1000, 2 * FILL_MIN_BLOCK - 1,
+				5 * FILL_MIN_BLOCK + 7};
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+	    size_t size = sizes[i];
+	    vector<uint32_t> expected(size + 1);
+	    xsadd_t seq;
+	    xsadd_init(&seq, 1234);
+	    for (size_t j = 0; j < size; j++) {
+		expected[j] = xsadd_uint32(&seq);
+	    }
+	    const int nthreads[] = {-1, 0, 1, 2, 3, 4, 5, 6, 7, INT_MIN};
+	    for (size_t k = 0; k < sizeof(nthreads) / sizeof(nthreads[0]);
+		 k++) {
+		vector<uint32_t> array(size + 1, 0);
+		xsadd_t xsadd;
+		xsadd_init(&xsadd, 1234);
+		xsadd_parallel_fill(&xsadd, &array[0], size, nthreads[k]);
+		CHECK(eq(seq, xsadd));
+		CHECK(array == expected);
+	    }
+	}
+    }
+    TEST(THREAD_LOCAL)
+    {
+	const int n = 8;
+	pthread_t threads[n];
+	thread_local_result r[n];
+	CHECK_EQUAL(0, xsadd_thread_local_seed(5678));
+	CHECK_EQUAL(-1, xsadd_thread_local_seed(1234));
+	for (int i = 0; i < n; i++) {
+	    CHECK_EQUAL(0, pthread_create(&threads[i], NULL,
+					  thread_local_run, &r[i]));
+	}
+	for (int i = 0; i < n; i++) {
+	    pthread_join(threads[i], NULL);
+	}
+	vector<bool> used(n, false);
+	for (int i = 0; i < n; i++) {
+	    xsadd_t expected;
+	    CHECK(r[i].same_pointer);
+	    CHECK(r[i].index < static_cast<uint64_t>(n));
+	    if (r[i].index >= static_cast<uint64_t>(n)) {
+		continue;
+	    }
+	    CHECK(!used[r[i].index]);
+	    used[r[i].index] = true;
+	    xsadd_init(&expected, 5678);
+	    xsadd_jump(&expected, static_cast<uint32_t>(r[i].index),
+		       xsadd_jump_base_step);
+	    CHECK(eq(expected, r[i].state));
+	}
+    }
+}
@@ -17,28 +17,17 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <inttypes.h>
-#include <time.h>
-#include <string.h>
 
-void speed(void);
 void print_output(void);
 
 int main(int argc, char * argv[])
 {
-    enum {PRINT, SPEED} mode;
-    if (argc <= 1) {
-	mode = PRINT;
-    } else if (strcmp(argv[1], "-s") == 0) {
-	mode = SPEED;
-    } else {
-	printf("%s [-s]\n", argv[0]);
+    if (argc > 1) {
+	printf("%s\n", argv[0]);
+	printf("speed is measured by bench_xsadd, see speed/bench_xsadd.c\n");
 	return 1;
     }
-    if (mode == PRINT) {
-	print_output();
-    } else {
-	speed();
-    }
+    print_output();
     return 0;
 }
 
@@ -87,17 +76,3 @@ void print_output()
         printf ("\n");
     }
 }
-
-void speed()
-{
-    xsadd_t xsa;
-    xsadd_init(&xsa, 1234);
-    clock_t start = clock();
-    uint32_t sum = 0;
-    for (int i = 0; i < 100000000; i++) {
-	sum ^= xsadd_uint32(&xsa);
-    }
-    double ell = clock() - start;
-    printf("consumed time for generating 10^8 numbers = %.2fms\n",
-	   (ell / CLOCKS_PER_SEC) * 1000);
-}
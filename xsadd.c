@@ -37,20 +37,64 @@
 #include <inttypes.h>
 #include <errno.h>
 #include <string.h>
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define XSADD_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define UNUSED __attribute__((unused))
+#else
+#define UNUSED
+#endif
 
 #define LOOP 8
 #define POLYNOMIAL_ARRAY_SIZE 8
 #define UZ_ARRAY_SIZE 8
+#define SH1 15
+#define SH2 18
+#define SH3 11
+#define FLOAT_MUL (1.0f / 16777216.0f)
+#define DOUBLE_MUL (1.0 / 9007199254740992.0)
+#define FILL_LANE_SIZE 16384
+#define FILL_CHUNK_SIZE 256
+/*
+ * xsadd_discard() steps one by one below this distance, and jumps
+ * above it. "bench_setup -f distance=" shows that stepping takes
+ * about 1.2ns per step and jumping by 2^k - 1 takes 300-400ns for
+ * k = 8, 9, so jumping is faster from about 512 steps.
+ */
+#define DISCARD_JUMP_THRESHOLD 512
+/*
+ * xsadd_rewind() steps back one by one below this distance, measured
+ * by bench_setup as above. Stepping back takes about 1.3ns per step.
+ * t<sup>-n</sup> has full degree even for small n, so jumping back
+ * takes 400-600ns for short distances, and it is faster from about
+ * 512 steps.
+ */
+#define REWIND_JUMP_THRESHOLD 512
 
 /*
- * this is hexadecimal string
+ * this is hexadecimal string.
+ * jump calculation uses mod_phi(), and this string and the
+ * generic polynomial_power_mod() are kept for the unit tests.
  */
-static const char * const characteristic_polynomial
+static const char * const characteristic_polynomial UNUSED
 = "100000000008101840085118000000001";
 
 /* 3^41 > 2^64 and 3^41 < 2^65 */
 const char * const xsadd_jump_base_step = "1FA2A1CF67B5FB863";
 
+/*
+ * jump polynomial of FILL_LANE_SIZE steps, i.e.
+ * xsadd_calculate_jump_poly(&poly, FILL_LANE_SIZE, "1"),
+ * "16e09e09f5e1cc7215e75f3b4b18364c" in string form.
+ */
+static const xsadd_jump_poly_t fill_lane_jump = {
+    {UINT64_C(0x15e75f3b4b18364c), UINT64_C(0x16e09e09f5e1cc72)}
+};
+
 /**
  * Polynomial over F<sub>2</sub>
  * LSB of ar[0], i.e. ar[0] & 1, represent constant
@@ -60,6 +104,17 @@ struct F2_POLYNOMIAL_T {
 };
 
 typedef struct F2_POLYNOMIAL_T f2_polynomial;
+
+/**
+ * Polynomial over F<sub>2</sub> of degree less than 128, that is,
+ * residue modulo the characteristic polynomial.
+ * LSB of ar[0], i.e. ar[0] & 1, represent constant
+ */
+struct F2_POLY128_T {
+    uint64_t ar[2];
+};
+
+typedef struct F2_POLY128_T f2_poly128;
 /**
  * unsigned integer
  * LSB of ar[0], i.e. ar[0] & 1, represent constant
@@ -71,7 +126,18 @@ struct UZ_T {
 typedef struct UZ_T uz;
 
 static void period_certification(xsadd_t * xsadd);
-static void xsadd_add(xsadd_t *dest, const xsadd_t *src);
+static void xsadd_add(xsadd_t *dest, const xsadd_t *src) UNUSED;
+static void jump_by_f2(xsadd_t * xsadd, const f2_polynomial * jump_poly)
+    UNUSED;
+static void jump_by_words(xsadd_t * xsadd, const uint32_t poly[], int size);
+static void discard_by_step(xsadd_t * xsadd, uint32_t n);
+static void rewind_by_step(xsadd_t * xsadd, uint32_t n);
+inline static void poly_to128(f2_poly128 * dest,
+			      const xsadd_jump_poly_t * jump_poly);
+inline static void poly_from128(xsadd_jump_poly_t * jump_poly,
+				const f2_poly128 * src);
+inline static void mul_mod_phi(f2_poly128 * x, const f2_poly128 * y);
+inline static void square_mod_phi(f2_poly128 * x);
 
 
 static void string16touz(uz * result, const char * str);
@@ -85,15 +151,743 @@ static void polynomialtostr(char * str, f2_polynomial * poly);
 static void polynomial_power_mod(f2_polynomial * dest,
 				 const f2_polynomial * x,
 				 uz * power,
-				 const f2_polynomial * mod);
+				 const f2_polynomial * mod) UNUSED;
 static void mod(f2_polynomial *dest, const f2_polynomial *x);
-inline static void shiftup1(f2_polynomial *dest);
+static void power_mod_phi(f2_poly128 * dest, const uz * power);
+static void power_mod_phi_u128(f2_poly128 * dest,
+			       uint64_t power_hi, uint64_t power_lo);
+static void power_back_mod_phi_u128(f2_poly128 * dest,
+				    uint64_t power_hi, uint64_t power_lo);
+static void mod_phi(f2_poly128 * dest, const uint64_t x[4]);
+inline static void to64(uint64_t dest[4], const f2_polynomial * x);
 inline static int deg(const f2_polynomial * x);
 inline static int deg_lazy(const f2_polynomial * x, const int pre_deg);
 inline static void clear(f2_polynomial * dest);
 inline static uint32_t ini_func1(uint32_t x);
 inline static uint32_t ini_func2(uint32_t x);
 
+/* ===================
+ * GENERATION KERNELS
+   =================== */
+/**
+ * bulk generation kernel.
+ * All kernels of the table give the same output, only speed differs.
+ */
+typedef struct {
+    const char * name;
+    int (*supported)(void);
+    void (*fill8)(xsadd8_t * xsadd8, uint32_t array[], size_t size);
+    void (*fill_lanes)(xsadd8_t * xsadd8, uint32_t array[], size_t count,
+		       size_t stride);
+    void (*to_float)(float dest[], const uint32_t src[], size_t size);
+    void (*to_double)(double dest[], const uint32_t src[], size_t size);
+    size_t (*bounded)(uint32_t dest[], const uint32_t src[], size_t size,
+		      uint32_t n, uint32_t t);
+} kernel_t;
+
+static int generic_supported(void)
+{
+    return 1;
+}
+
+static void xsadd8_fill_generic(xsadd8_t * xsadd8, uint32_t array[],
+				size_t size)
+{
+    for (size_t i = 0; i + XSADD8_LANES <= size; i += XSADD8_LANES) {
+	xsadd8_uint32(xsadd8, &array[i]);
+    }
+}
+
+/**
+ * fill array with 32-bit unsigned integers, one by one.
+ * The state is copied to local variables, which are expected to be
+ * kept in registers through the loop.
+ * @param xsadd xsadd internal state
+ * @param array the array to be filled
+ * @param size number of elements of the array
+ */
+static void fill_generic(xsadd_t * xsadd, uint32_t array[], size_t size)
+{
+    uint32_t s0 = xsadd->state[0];
+    uint32_t s1 = xsadd->state[1];
+    uint32_t s2 = xsadd->state[2];
+    uint32_t s3 = xsadd->state[3];
+    uint32_t t;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+	t = s0 ^ (s0 << SH1);
+	s0 = t ^ (t >> SH2) ^ (s3 << SH3);
+	array[i] = s0 + s3;
+	t = s1 ^ (s1 << SH1);
+	s1 = t ^ (t >> SH2) ^ (s0 << SH3);
+	array[i + 1] = s1 + s0;
+	t = s2 ^ (s2 << SH1);
+	s2 = t ^ (t >> SH2) ^ (s1 << SH3);
+	array[i + 2] = s2 + s1;
+	t = s3 ^ (s3 << SH1);
+	s3 = t ^ (t >> SH2) ^ (s2 << SH3);
+	array[i + 3] = s3 + s2;
+    }
+    for (; i < size; i++) {
+	t = s0 ^ (s0 << SH1);
+	t = t ^ (t >> SH2) ^ (s3 << SH3);
+	s0 = s1;
+	s1 = s2;
+	s2 = s3;
+	s3 = t;
+	array[i] = s3 + s2;
+    }
+    xsadd->state[0] = s0;
+    xsadd->state[1] = s1;
+    xsadd->state[2] = s2;
+    xsadd->state[3] = s3;
+}
+
+/**
+ * conversion to floating point numbers in the range [0, 1), the same
+ * as xsadd_float().
+ * @param dest floating point numbers
+ * @param src 32-bit unsigned integers
+ * @param size number of elements of dest and src
+ */
+static void to_float_generic(float dest[], const uint32_t src[], size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+	dest[i] = (src[i] >> 8) * FLOAT_MUL;
+    }
+}
+
+/**
+ * conversion to double precision floating point numbers in the range
+ * [0, 1), the same as xsadd_double().
+ * @param dest floating point numbers
+ * @param src 32-bit unsigned integers, two for each number
+ * @param size number of elements of dest
+ */
+static void to_double_generic(double dest[], const uint32_t src[],
+			      size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+	uint64_t a = src[2 * i];
+	uint64_t b = src[2 * i + 1];
+	dest[i] = ((a << 21) | (b >> 11)) * DOUBLE_MUL;
+    }
+}
+
+/**
+ * multiply-shift of xsadd_uint32_bounded() until the first rejection.
+ * dest may overlap src if dest <= src.
+ * @param dest results, (src[i] * n) >> 32
+ * @param src 32-bit unsigned integers
+ * @param size number of elements of src
+ * @param n upper bound
+ * @param t threshold, 2<sup>32</sup> % n
+ * @return index of the first rejected element, or size if none.
+ */
+static size_t bounded_generic(uint32_t dest[], const uint32_t src[],
+			      size_t size, uint32_t n, uint32_t t)
+{
+    for (size_t i = 0; i < size; i++) {
+	uint64_t m = (uint64_t)src[i] * n;
+	if ((uint32_t)m < t) {
+	    return i;
+	}
+	dest[i] = (uint32_t)(m >> 32);
+    }
+    return size;
+}
+
+#if defined(XSADD_X86_KERNELS)
+static int sse2_supported(void)
+{
+    return __builtin_cpu_supports("sse2");
+}
+
+static int avx2_supported(void)
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+static int avx512_supported(void)
+{
+    return __builtin_cpu_supports("avx512f")
+	&& __builtin_cpu_supports("avx512vl");
+}
+
+/**
+ * xsadd8 kernel using two 128-bit registers for each state word.
+ */
+__attribute__((target("sse2")))
+static void xsadd8_fill_sse2(xsadd8_t * xsadd8, uint32_t array[],
+			     size_t size)
+{
+    __m128i s[4][2];
+    __m128i t;
+    for (int i = 0; i < 4; i++) {
+	for (int j = 0; j < 2; j++) {
+	    s[i][j] = _mm_loadu_si128((const __m128i *)
+				      &xsadd8->state[i][j * 4]);
+	}
+    }
+    for (size_t i = 0; i + XSADD8_LANES <= size; i += XSADD8_LANES) {
+	for (int j = 0; j < 2; j++) {
+	    t = _mm_xor_si128(s[0][j], _mm_slli_epi32(s[0][j], SH1));
+	    t = _mm_xor_si128(t, _mm_srli_epi32(t, SH2));
+	    t = _mm_xor_si128(t, _mm_slli_epi32(s[3][j], SH3));
+	    s[0][j] = s[1][j];
+	    s[1][j] = s[2][j];
+	    s[2][j] = s[3][j];
+	    s[3][j] = t;
+	    _mm_storeu_si128((__m128i *)&array[i + j * 4],
+			     _mm_add_epi32(s[3][j], s[2][j]));
+	}
+    }
+    for (int i = 0; i < 4; i++) {
+	for (int j = 0; j < 2; j++) {
+	    _mm_storeu_si128((__m128i *)&xsadd8->state[i][j * 4], s[i][j]);
+	}
+    }
+}
+
+/**
+ * single stream kernel using eight lanes, see fill_by_lanes().
+ * Outputs of four steps are transposed and stored to each lane's
+ * part of the array, the lane j generates count outputs to
+ * array[j * stride].
+ */
+__attribute__((target("sse2")))
+static void fill_lanes_sse2(xsadd8_t * xsadd8, uint32_t array[],
+			    size_t count, size_t stride)
+{
+    __m128i s[4][2];
+    __m128i t;
+    __m128i r[4];
+    for (int i = 0; i < 4; i++) {
+	for (int j = 0; j < 2; j++) {
+	    s[i][j] = _mm_loadu_si128((const __m128i *)
+				      &xsadd8->state[i][j * 4]);
+	}
+    }
+    for (size_t k = 0; k < count; k += 4) {
+	for (int j = 0; j < 2; j++) {
+	    for (int q = 0; q < 4; q++) {
+		t = _mm_xor_si128(s[0][j], _mm_slli_epi32(s[0][j], SH1));
+		t = _mm_xor_si128(t, _mm_srli_epi32(t, SH2));
+		t = _mm_xor_si128(t, _mm_slli_epi32(s[3][j], SH3));
+		s[0][j] = s[1][j];
+		s[1][j] = s[2][j];
+		s[2][j] = s[3][j];
+		s[3][j] = t;
+		r[q] = _mm_add_epi32(s[3][j], s[2][j]);
+	    }
+	    __m128i t0 = _mm_unpacklo_epi32(r[0], r[1]);
+	    __m128i t1 = _mm_unpackhi_epi32(r[0], r[1]);
+	    __m128i t2 = _mm_unpacklo_epi32(r[2], r[3]);
+	    __m128i t3 = _mm_unpackhi_epi32(r[2], r[3]);
+	    uint32_t * p = &array[j * 4 * stride + k];
+	    _mm_storeu_si128((__m128i *)p, _mm_unpacklo_epi64(t0, t2));
+	    p += stride;
+	    _mm_storeu_si128((__m128i *)p, _mm_unpackhi_epi64(t0, t2));
+	    p += stride;
+	    _mm_storeu_si128((__m128i *)p, _mm_unpacklo_epi64(t1, t3));
+	    p += stride;
+	    _mm_storeu_si128((__m128i *)p, _mm_unpackhi_epi64(t1, t3));
+	}
+    }
+    for (int i = 0; i < 4; i++) {
+	for (int j = 0; j < 2; j++) {
+	    _mm_storeu_si128((__m128i *)&xsadd8->state[i][j * 4], s[i][j]);
+	}
+    }
+}
+
+/**
+ * conversion to float by int to float conversion instruction.
+ * (x >> 8) is less than 2<sup>24</sup>, so the conversion is exact.
+ */
+__attribute__((target("sse2")))
+static void to_float_sse2(float dest[], const uint32_t src[], size_t size)
+{
+    const __m128 mul = _mm_set1_ps(FLOAT_MUL);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+	__m128i x = _mm_loadu_si128((const __m128i *)&src[i]);
+	__m128 f = _mm_cvtepi32_ps(_mm_srli_epi32(x, 8));
+	_mm_storeu_ps(&dest[i], _mm_mul_ps(f, mul));
+    }
+    to_float_generic(&dest[i], &src[i], size - i);
+}
+
+/**
+ * conversion to double by exponent bits.
+ * A 32-bit integer x is converted exactly by setting the exponent of
+ * 2<sup>52</sup> and subtracting 2<sup>52</sup>. The result is
+ * a * 2<sup>-32</sup> + (b >> 11) * 2<sup>-53</sup>, which is exact
+ * and the same as xsadd_double().
+ */
+__attribute__((target("sse2")))
+static void to_double_sse2(double dest[], const uint32_t src[], size_t size)
+{
+    const __m128i low = _mm_set1_epi64x(INT64_C(0xffffffff));
+    const __m128i exp52 = _mm_set1_epi64x(INT64_C(0x4330000000000000));
+    const __m128d two52 = _mm_set1_pd(4503599627370496.0);
+    const __m128d mul_a = _mm_set1_pd(1.0 / 4294967296.0);
+    const __m128d mul_b = _mm_set1_pd(DOUBLE_MUL);
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+	__m128i x = _mm_loadu_si128((const __m128i *)&src[2 * i]);
+	__m128i a = _mm_or_si128(_mm_and_si128(x, low), exp52);
+	__m128i b = _mm_or_si128(_mm_srli_epi64(x, 43), exp52);
+	__m128d da = _mm_sub_pd(_mm_castsi128_pd(a), two52);
+	__m128d db = _mm_sub_pd(_mm_castsi128_pd(b), two52);
+	_mm_storeu_pd(&dest[i], _mm_add_pd(_mm_mul_pd(da, mul_a),
+					   _mm_mul_pd(db, mul_b)));
+    }
+    to_double_generic(&dest[i], &src[2 * i], size - i);
+}
+
+/**
+ * xsadd8 kernel keeping each state word of all lanes in one 256-bit
+ * register.
+ */
+__attribute__((target("avx2")))
+static void xsadd8_fill_avx2(xsadd8_t * xsadd8, uint32_t array[],
+			     size_t size)
+{
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)xsadd8->state[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)xsadd8->state[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i *)xsadd8->state[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i *)xsadd8->state[3]);
+    __m256i t;
+    for (size_t i = 0; i + XSADD8_LANES <= size; i += XSADD8_LANES) {
+	t = _mm256_xor_si256(s0, _mm256_slli_epi32(s0, SH1));
+	t = _mm256_xor_si256(t, _mm256_srli_epi32(t, SH2));
+	t = _mm256_xor_si256(t, _mm256_slli_epi32(s3, SH3));
+	s0 = s1;
+	s1 = s2;
+	s2 = s3;
+	s3 = t;
+	_mm256_storeu_si256((__m256i *)&array[i], _mm256_add_epi32(s3, s2));
+    }
+    _mm256_storeu_si256((__m256i *)xsadd8->state[0], s0);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[1], s1);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[2], s2);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[3], s3);
+}
+
+/**
+ * transpose 8x8 matrix of 32-bit integers and store row j to
+ * array[j * stride].
+ * @param array destination
+ * @param r rows, r[q] holds the outputs of the step q of all lanes
+ * @param stride distance between rows in the array
+ */
+__attribute__((target("avx2")))
+static inline void store_transposed_avx2(uint32_t array[], const __m256i r[8],
+					 size_t stride)
+{
+    __m256i t[8];
+    __m256i u[8];
+    for (int q = 0; q < 8; q += 2) {
+	t[q] = _mm256_unpacklo_epi32(r[q], r[q + 1]);
+	t[q + 1] = _mm256_unpackhi_epi32(r[q], r[q + 1]);
+    }
+    for (int q = 0; q < 8; q += 4) {
+	u[q] = _mm256_unpacklo_epi64(t[q], t[q + 2]);
+	u[q + 1] = _mm256_unpackhi_epi64(t[q], t[q + 2]);
+	u[q + 2] = _mm256_unpacklo_epi64(t[q + 1], t[q + 3]);
+	u[q + 3] = _mm256_unpackhi_epi64(t[q + 1], t[q + 3]);
+    }
+    for (int j = 0; j < 4; j++) {
+	_mm256_storeu_si256((__m256i *)&array[j * stride],
+			    _mm256_permute2x128_si256(u[j], u[j + 4], 0x20));
+	_mm256_storeu_si256((__m256i *)&array[(j + 4) * stride],
+			    _mm256_permute2x128_si256(u[j], u[j + 4], 0x31));
+    }
+}
+
+/**
+ * single stream kernel using eight lanes, see fill_by_lanes().
+ * The lane j generates count outputs to array[j * stride].
+ */
+__attribute__((target("avx2")))
+static void fill_lanes_avx2(xsadd8_t * xsadd8, uint32_t array[],
+			    size_t count, size_t stride)
+{
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)xsadd8->state[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)xsadd8->state[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i *)xsadd8->state[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i *)xsadd8->state[3]);
+    __m256i t;
+    __m256i r[8];
+    for (size_t k = 0; k < count; k += 8) {
+	for (int q = 0; q < 8; q++) {
+	    t = _mm256_xor_si256(s0, _mm256_slli_epi32(s0, SH1));
+	    t = _mm256_xor_si256(t, _mm256_srli_epi32(t, SH2));
+	    t = _mm256_xor_si256(t, _mm256_slli_epi32(s3, SH3));
+	    s0 = s1;
+	    s1 = s2;
+	    s2 = s3;
+	    s3 = t;
+	    r[q] = _mm256_add_epi32(s3, s2);
+	}
+	store_transposed_avx2(&array[k], r, stride);
+    }
+    _mm256_storeu_si256((__m256i *)xsadd8->state[0], s0);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[1], s1);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[2], s2);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[3], s3);
+}
+
+/**
+ * conversion to float, same as to_float_sse2().
+ */
+__attribute__((target("avx2")))
+static void to_float_avx2(float dest[], const uint32_t src[], size_t size)
+{
+    const __m256 mul = _mm256_set1_ps(FLOAT_MUL);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+	__m256i x = _mm256_loadu_si256((const __m256i *)&src[i]);
+	__m256 f = _mm256_cvtepi32_ps(_mm256_srli_epi32(x, 8));
+	_mm256_storeu_ps(&dest[i], _mm256_mul_ps(f, mul));
+    }
+    to_float_generic(&dest[i], &src[i], size - i);
+}
+
+/**
+ * conversion to double, same as to_double_sse2().
+ */
+__attribute__((target("avx2")))
+static void to_double_avx2(double dest[], const uint32_t src[], size_t size)
+{
+    const __m256i low = _mm256_set1_epi64x(INT64_C(0xffffffff));
+    const __m256i exp52 = _mm256_set1_epi64x(INT64_C(0x4330000000000000));
+    const __m256d two52 = _mm256_set1_pd(4503599627370496.0);
+    const __m256d mul_a = _mm256_set1_pd(1.0 / 4294967296.0);
+    const __m256d mul_b = _mm256_set1_pd(DOUBLE_MUL);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+	__m256i x = _mm256_loadu_si256((const __m256i *)&src[2 * i]);
+	__m256i a = _mm256_or_si256(_mm256_and_si256(x, low), exp52);
+	__m256i b = _mm256_or_si256(_mm256_srli_epi64(x, 43), exp52);
+	__m256d da = _mm256_sub_pd(_mm256_castsi256_pd(a), two52);
+	__m256d db = _mm256_sub_pd(_mm256_castsi256_pd(b), two52);
+	_mm256_storeu_pd(&dest[i], _mm256_add_pd(_mm256_mul_pd(da, mul_a),
+						 _mm256_mul_pd(db, mul_b)));
+    }
+    to_double_generic(&dest[i], &src[2 * i], size - i);
+}
+
+/**
+ * multiply-shift of eight elements at once.
+ * Products of even and odd elements are made by two vpmuludq, and
+ * the high and low halves are gathered by blend. Eight elements
+ * are stored only if none of them is rejected, otherwise the index
+ * of the group is returned and the caller handles it.
+ */
+__attribute__((target("avx2")))
+static size_t bounded_avx2(uint32_t dest[], const uint32_t src[],
+			   size_t size, uint32_t n, uint32_t t)
+{
+    const __m256i vn = _mm256_set1_epi32((int32_t)n);
+    const __m256i vt = _mm256_set1_epi32((int32_t)t);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+	__m256i x = _mm256_loadu_si256((const __m256i *)&src[i]);
+	__m256i even = _mm256_mul_epu32(x, vn);
+	__m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), vn);
+	__m256i high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd,
+					  0xaa);
+	__m256i low = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32),
+					 0xaa);
+	__m256i ok = _mm256_cmpeq_epi32(_mm256_max_epu32(low, vt), low);
+	if (_mm256_movemask_epi8(ok) != -1) {
+	    return i;
+	}
+	_mm256_storeu_si256((__m256i *)&dest[i], high);
+    }
+    return i + bounded_generic(&dest[i], &src[i], size - i, n, t);
+}
+
+/**
+ * xsadd8 kernel same as avx2 one, except that the three way
+ * exclusive or is done by one vpternlogd instruction.
+ */
+__attribute__((target("avx2,avx512f,avx512vl")))
+static void xsadd8_fill_avx512(xsadd8_t * xsadd8, uint32_t array[],
+			       size_t size)
+{
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)xsadd8->state[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)xsadd8->state[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i *)xsadd8->state[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i *)xsadd8->state[3]);
+    __m256i t;
+    for (size_t i = 0; i + XSADD8_LANES <= size; i += XSADD8_LANES) {
+	t = _mm256_xor_si256(s0, _mm256_slli_epi32(s0, SH1));
+	t = _mm256_ternarylogic_epi32(t, _mm256_srli_epi32(t, SH2),
+				      _mm256_slli_epi32(s3, SH3), 0x96);
+	s0 = s1;
+	s1 = s2;
+	s2 = s3;
+	s3 = t;
+	_mm256_storeu_si256((__m256i *)&array[i], _mm256_add_epi32(s3, s2));
+    }
+    _mm256_storeu_si256((__m256i *)xsadd8->state[0], s0);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[1], s1);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[2], s2);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[3], s3);
+}
+/**
+ * single stream kernel same as avx2 one, except that the three way
+ * exclusive or is done by one vpternlogd instruction.
+ */
+__attribute__((target("avx2,avx512f,avx512vl")))
+static void fill_lanes_avx512(xsadd8_t * xsadd8, uint32_t array[],
+			      size_t count, size_t stride)
+{
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)xsadd8->state[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)xsadd8->state[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i *)xsadd8->state[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i *)xsadd8->state[3]);
+    __m256i t;
+    __m256i r[8];
+    for (size_t k = 0; k < count; k += 8) {
+	for (int q = 0; q < 8; q++) {
+	    t = _mm256_xor_si256(s0, _mm256_slli_epi32(s0, SH1));
+	    t = _mm256_ternarylogic_epi32(t, _mm256_srli_epi32(t, SH2),
+					  _mm256_slli_epi32(s3, SH3), 0x96);
+	    s0 = s1;
+	    s1 = s2;
+	    s2 = s3;
+	    s3 = t;
+	    r[q] = _mm256_add_epi32(s3, s2);
+	}
+	store_transposed_avx2(&array[k], r, stride);
+    }
+    _mm256_storeu_si256((__m256i *)xsadd8->state[0], s0);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[1], s1);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[2], s2);
+    _mm256_storeu_si256((__m256i *)xsadd8->state[3], s3);
+}
+#endif
+
+/**
+ * kernel table, the widest first.
+ * The conversions of avx2 are used for avx512, because 512-bit
+ * conversions are not faster when the output is limited by memory.
+ * SSE2 has no unsigned comparison and no blend, so sse2 uses the
+ * generic multiply-shift.
+ */
+static const kernel_t kernels[] = {
+#if defined(XSADD_X86_KERNELS)
+    {"avx512", avx512_supported, xsadd8_fill_avx512, fill_lanes_avx512,
+     to_float_avx2, to_double_avx2, bounded_avx2},
+    {"avx2", avx2_supported, xsadd8_fill_avx2, fill_lanes_avx2,
+     to_float_avx2, to_double_avx2, bounded_avx2},
+    {"sse2", sse2_supported, xsadd8_fill_sse2, fill_lanes_sse2,
+     to_float_sse2, to_double_sse2, bounded_generic},
+#endif
+    {"generic", generic_supported, xsadd8_fill_generic, NULL,
+     to_float_generic, to_double_generic, bounded_generic}
+};
+
+#define KERNEL_COUNT ((int)(sizeof(kernels) / sizeof(kernels[0])))
+
+/**
+ * selected kernel, NULL until first use.
+ * This is read by the worker threads of xsadd_parallel_fill() and may
+ * be written by xsadd_set_kernel() at the same time, so it is only
+ * accessed by atomic builtins. The release store publishes the
+ * selection, and the acquire load sees it.
+ */
+static const kernel_t * selected_kernel = NULL;
+
+/**
+ * search kernel by name.
+ * @param name kernel name
+ * @return the kernel, or NULL if it is unknown or not supported by the
+ * CPU.
+ */
+static const kernel_t * find_kernel(const char * name)
+{
+    for (int i = 0; i < KERNEL_COUNT; i++) {
+	if (strcmp(kernels[i].name, name) == 0) {
+	    if (kernels[i].supported()) {
+		return &kernels[i];
+	    }
+	    return NULL;
+	}
+    }
+    return NULL;
+}
+
+/**
+ * get the kernel used for bulk generation.
+ * At the first call, the kernel named by environment variable
+ * XSADD_KERNEL is selected if it is supported, otherwise the widest
+ * kernel the CPU supports is selected.
+ * @return the kernel
+ */
+static const kernel_t * get_kernel(void)
+{
+    const kernel_t * selected = __atomic_load_n(&selected_kernel,
+						__ATOMIC_ACQUIRE);
+    if (selected != NULL) {
+	return selected;
+    }
+    const kernel_t * k = NULL;
+    const char * env = getenv("XSADD_KERNEL");
+    if (env != NULL) {
+	k = find_kernel(env);
+    }
+    for (int i = 0; k == NULL && i < KERNEL_COUNT; i++) {
+	if (kernels[i].supported()) {
+	    k = &kernels[i];
+	}
+    }
+    /* keep the kernel set by another thread or xsadd_set_kernel() */
+    if (!__atomic_compare_exchange_n(&selected_kernel, &selected, k, 0,
+				     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+	return selected;
+    }
+    return k;
+}
+
+/**
+ * set eight lanes for fill_by_lanes(), the lane j is the state jumped
+ * by j * FILL_LANE_SIZE steps.
+ * @param lanes eight lanes
+ * @param xsadd xsadd internal state
+ */
+static void set_lanes(xsadd8_t * lanes, const xsadd_t * xsadd)
+{
+    xsadd_t work = *xsadd;
+    for (int j = 0; j < XSADD8_LANES; j++) {
+	if (j > 0) {
+	    xsadd_jump_by_poly(&work, &fill_lane_jump);
+	}
+	for (int i = 0; i < 4; i++) {
+	    lanes->state[i][j] = work.state[i];
+	}
+    }
+}
+
+/**
+ * fill array by splitting it into eight lanes.
+ * The array is divided into blocks of XSADD8_LANES * FILL_LANE_SIZE
+ * elements, and the lane j of a block is generated from the state
+ * jumped by j * FILL_LANE_SIZE steps. Because jump is exact, the
+ * array is the same as the one filled one by one.
+ * @param xsadd xsadd internal state
+ * @param array the array to be filled
+ * @param size number of elements of the array
+ * @param fill_lanes kernel generating outputs of each lane
+ * @return number of elements filled, a multiple of the block size.
+ */
+static size_t fill_by_lanes(xsadd_t * xsadd, uint32_t array[], size_t size,
+			    void (*fill_lanes)(xsadd8_t *, uint32_t [],
+					       size_t, size_t))
+{
+    const size_t block = XSADD8_LANES * FILL_LANE_SIZE;
+    size_t done = 0;
+    xsadd8_t lanes;
+    for (; done + block <= size; done += block) {
+	set_lanes(&lanes, xsadd);
+	fill_lanes(&lanes, &array[done], FILL_LANE_SIZE, FILL_LANE_SIZE);
+	xsadd8_get_lane(xsadd, &lanes, XSADD8_LANES - 1);
+    }
+    return done;
+}
+
+/**
+ * consumer of generated words, see generate_words().
+ * @param k the kernel
+ * @param dest destination array
+ * @param pos position of words[0] in the generated sequence
+ * @param words generated words
+ * @param count number of words, an even number if size of
+ * generate_words() is even
+ */
+typedef void (*put_words_t)(const kernel_t * k, void * dest, size_t pos,
+			    const uint32_t words[], size_t count);
+
+/**
+ * generate words and pass them to put() through a small buffer.
+ * This is the same as fill_by_lanes() followed by fill_generic(),
+ * except that the lanes are generated by FILL_CHUNK_SIZE words, so
+ * that the words are converted while they are in the L1 cache.
+ * @param xsadd xsadd internal state
+ * @param size number of words
+ * @param put consumer of words
+ * @param dest destination array passed to put()
+ */
+static void generate_words(xsadd_t * xsadd, size_t size, put_words_t put,
+			   void * dest)
+{
+    const kernel_t * k = get_kernel();
+    uint32_t buff[XSADD8_LANES * FILL_CHUNK_SIZE];
+    size_t done = 0;
+    if (k->fill_lanes != NULL) {
+	const size_t block = XSADD8_LANES * FILL_LANE_SIZE;
+	xsadd8_t lanes;
+	for (; done + block <= size; done += block) {
+	    set_lanes(&lanes, xsadd);
+	    for (size_t c = 0; c < FILL_LANE_SIZE; c += FILL_CHUNK_SIZE) {
+		k->fill_lanes(&lanes, buff, FILL_CHUNK_SIZE, FILL_CHUNK_SIZE);
+		for (int j = 0; j < XSADD8_LANES; j++) {
+		    put(k, dest, done + j * FILL_LANE_SIZE + c,
+			&buff[j * FILL_CHUNK_SIZE], FILL_CHUNK_SIZE);
+		}
+	    }
+	    xsadd8_get_lane(xsadd, &lanes, XSADD8_LANES - 1);
+	}
+    }
+    while (done < size) {
+	size_t len = size - done;
+	if (len > XSADD8_LANES * FILL_CHUNK_SIZE) {
+	    len = XSADD8_LANES * FILL_CHUNK_SIZE;
+	}
+	fill_generic(xsadd, buff, len);
+	put(k, dest, done, buff, len);
+	done += len;
+    }
+}
+
+static void put_float(const kernel_t * k, void * dest, size_t pos,
+		      const uint32_t words[], size_t count)
+{
+    k->to_float((float *)dest + pos, words, count);
+}
+
+/**
+ * xsadd_floatOC() uses the second of two words.
+ */
+static void put_floatOC(const kernel_t * k UNUSED, void * dest, size_t pos,
+			const uint32_t words[], size_t count)
+{
+    float * array = (float *)dest + pos / 2;
+    for (size_t i = 0; i < count / 2; i++) {
+	array[i] = 1.0f - (words[2 * i + 1] >> 8) * FLOAT_MUL;
+    }
+}
+
+static void put_double(const kernel_t * k, void * dest, size_t pos,
+		       const uint32_t words[], size_t count)
+{
+    k->to_double((double *)dest + pos / 2, words, count / 2);
+}
+
+static void put_doubleOC(const kernel_t * k, void * dest, size_t pos,
+			 const uint32_t words[], size_t count)
+{
+    double * array = (double *)dest + pos / 2;
+    k->to_double(array, words, count / 2);
+    for (size_t i = 0; i < count / 2; i++) {
+	array[i] = 1.0 - array[i];
+    }
+}
+
 /* ================
  * PUBLIC FUNCTIONS
    ================ */
@@ -178,78 +972,480 @@ void xsadd_init_by_array(xsadd_t * random,
     }
 }
 
-/**
- * jump function
- * @param xsadd xsadd structure, overwritten by new state after calling
- * this function.
- * @param mul_step jump step is mul_step * base_step.
- * @param base_step hexadecimal number string less than 2<sup>128</sup>.
- * xsadddc
- */
-void xsadd_jump(xsadd_t *xsadd,
-		uint32_t mul_step,
-		const char * base_step)
+/**
+ * fill array with 32-bit unsigned integers.
+ * Large arrays are filled by the vector kernel, see fill_by_lanes().
+ * @param xsadd xsadd internal state
+ * @param array the array to be filled
+ * @param size number of elements of the array
+ */
+void xsadd_fill_array_uint32(xsadd_t * xsadd, uint32_t array[], size_t size)
+{
+    const kernel_t * k = get_kernel();
+    size_t done = 0;
+    if (k->fill_lanes != NULL) {
+	done = fill_by_lanes(xsadd, array, size, k->fill_lanes);
+    }
+    fill_generic(xsadd, &array[done], size - done);
+}
+
+/**
+ * fill array with integers in the range [0, n).
+ * The words are generated in the array by blocks of fill_by_lanes(),
+ * and transformed in place while they are in cache. After a
+ * rejection, the results are written behind the words, so the words
+ * are generated again for the rest of the block.
+ * @param xsadd xsadd internal state
+ * @param array the array to be filled
+ * @param size number of elements of the array
+ * @param n upper bound
+ */
+void xsadd_fill_bounded(xsadd_t * xsadd, uint32_t array[], size_t size,
+			uint32_t n)
+{
+    const kernel_t * k = get_kernel();
+    uint32_t t = 0;
+    size_t done = 0;
+    if (n != 0) {
+	t = (0 - n) % n;
+    }
+    while (done < size) {
+	size_t w = done;
+	size_t r = done;
+	size_t end = size;
+	if (end - done > XSADD8_LANES * FILL_LANE_SIZE) {
+	    end = done + XSADD8_LANES * FILL_LANE_SIZE;
+	}
+	xsadd_fill_array_uint32(xsadd, &array[done], end - done);
+	while (r < end) {
+	    size_t len = k->bounded(&array[w], &array[r], end - r, n, t);
+	    r += len;
+	    w += len;
+	    if (r < end) {
+		uint64_t m = (uint64_t)array[r] * n;
+		r++;
+		if ((uint32_t)m >= t) {
+		    array[w] = (uint32_t)(m >> 32);
+		    w++;
+		}
+	    }
+	}
+	done = w;
+    }
+}
+
+/**
+ * fill array with floating point numbers in the range [0, 1).
+ * Large arrays are generated by eight lanes, and converted by the
+ * vector kernel.
+ * @param xsadd xsadd internal state
+ * @param array the array to be filled
+ * @param size number of elements of the array
+ */
+void xsadd_fill_array_float(xsadd_t * xsadd, float array[], size_t size)
+{
+    generate_words(xsadd, size, put_float, array);
+}
+
+void xsadd_fill_array_floatOC(xsadd_t * xsadd, float array[], size_t size)
+{
+    generate_words(xsadd, size * 2, put_floatOC, array);
+}
+
+/**
+ * fill array with double precision floating point numbers in the
+ * range [0, 1).
+ * @param xsadd xsadd internal state
+ * @param array the array to be filled
+ * @param size number of elements of the array
+ */
+void xsadd_fill_array_double(xsadd_t * xsadd, double array[], size_t size)
+{
+    generate_words(xsadd, size * 2, put_double, array);
+}
+
+void xsadd_fill_array_doubleOC(xsadd_t * xsadd, double array[], size_t size)
+{
+    generate_words(xsadd, size * 2, put_doubleOC, array);
+}
+
+void xsadd8_init(xsadd8_t * xsadd8, uint32_t seed)
+{
+    xsadd_t xsadd;
+    xsadd_init(&xsadd, seed);
+    xsadd8_init_by_xsadd(xsadd8, &xsadd);
+}
+
+void xsadd8_init_by_xsadd(xsadd8_t * xsadd8, const xsadd_t * xsadd)
+{
+    xsadd_jump_poly_t jump_poly;
+    xsadd_t work = *xsadd;
+    xsadd_calculate_jump_poly(&jump_poly, 1, xsadd_jump_base_step);
+    for (int j = 0; j < XSADD8_LANES; j++) {
+	if (j > 0) {
+	    xsadd_jump_by_poly(&work, &jump_poly);
+	}
+	for (int i = 0; i < 4; i++) {
+	    xsadd8->state[i][j] = work.state[i];
+	}
+    }
+}
+
+void xsadd8_fill_array_uint32(xsadd8_t * xsadd8, uint32_t array[],
+			      size_t size)
+{
+    get_kernel()->fill8(xsadd8, array, size);
+}
+
+const char * xsadd_kernel_name(void)
+{
+    return get_kernel()->name;
+}
+
+int xsadd_set_kernel(const char * name)
+{
+    const kernel_t * k = find_kernel(name);
+    if (k == NULL) {
+	return -1;
+    }
+    __atomic_store_n(&selected_kernel, k, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/**
+ * jump function
+ * @param xsadd xsadd structure, overwritten by new state after calling
+ * this function.
+ * @param mul_step jump step is mul_step * base_step.
+ * @param base_step hexadecimal number string less than 2<sup>128</sup>.
+ * xsadddc
+ */
+void xsadd_jump(xsadd_t *xsadd,
+		uint32_t mul_step,
+		const char * base_step)
+{
+    xsadd_jump_poly_t jump_poly;
+    xsadd_calculate_jump_poly(&jump_poly, mul_step, base_step);
+    xsadd_jump_by_poly(xsadd, &jump_poly);
+}
+
+/**
+ * jump using the jump polynomial.
+ * This function is not as time consuming as calculating jump polynomial.
+ * This function can use multiple time for the xsadd structure.
+ * @param xsadd xsadd structure, overwritten by new state after calling
+ * this function.
+ * @param jump_str the jump polynomial calculated by
+ * xsadd_calculate_jump_polynomial.
+ */
+void xsadd_jump_by_polynomial(xsadd_t *xsadd, const char * jump_str)
+{
+    xsadd_jump_poly_t jump_poly;
+    xsadd_jump_poly_from_str(&jump_poly, jump_str);
+    xsadd_jump_by_poly(xsadd, &jump_poly);
+}
+
+void xsadd_calculate_jump_polynomial(char *jump_str,
+				     uint32_t mul_step,
+				     const char * base_step)
+{
+    xsadd_jump_poly_t jump_poly;
+    xsadd_calculate_jump_poly(&jump_poly, mul_step, base_step);
+    xsadd_jump_poly_to_str(jump_str, &jump_poly);
+}
+
+void xsadd_calculate_jump_poly(xsadd_jump_poly_t * jump_poly,
+			       uint32_t mul_step,
+			       const char * base_step)
+{
+    f2_poly128 jump128;
+    uz base;
+    uz mul;
+    uz step;
+
+    string16touz(&base, base_step);
+    uint32touz(&mul, mul_step);
+    uz_mul(&step, &mul, &base);
+    power_mod_phi(&jump128, &step);
+    poly_from128(jump_poly, &jump128);
+}
+
+void xsadd_calculate_jump_poly_u128(xsadd_jump_poly_t * jump_poly,
+				    uint64_t step_hi, uint64_t step_lo)
+{
+    f2_poly128 jump128;
+    power_mod_phi_u128(&jump128, step_hi, step_lo);
+    poly_from128(jump_poly, &jump128);
+}
+
+void xsadd_jump_u128(xsadd_t * xsadd, uint64_t step_hi, uint64_t step_lo)
+{
+    xsadd_jump_poly_t jump_poly;
+    xsadd_calculate_jump_poly_u128(&jump_poly, step_hi, step_lo);
+    xsadd_jump_by_poly(xsadd, &jump_poly);
+}
+
+void xsadd_discard(xsadd_t * xsadd, uint64_t n)
+{
+    if (n < DISCARD_JUMP_THRESHOLD) {
+	discard_by_step(xsadd, (uint32_t)n);
+    } else {
+	xsadd_jump_u128(xsadd, 0, n);
+    }
+}
+
+void xsadd_calculate_jump_back_poly_u128(xsadd_jump_poly_t * jump_poly,
+					 uint64_t step_hi, uint64_t step_lo)
+{
+    f2_poly128 jump128;
+    power_back_mod_phi_u128(&jump128, step_hi, step_lo);
+    poly_from128(jump_poly, &jump128);
+}
+
+void xsadd_jump_back_u128(xsadd_t * xsadd, uint64_t step_hi, uint64_t step_lo)
+{
+    xsadd_jump_poly_t jump_poly;
+    xsadd_calculate_jump_back_poly_u128(&jump_poly, step_hi, step_lo);
+    xsadd_jump_by_poly(xsadd, &jump_poly);
+}
+
+void xsadd_rewind(xsadd_t * xsadd, uint64_t n)
+{
+    if (n < REWIND_JUMP_THRESHOLD) {
+	rewind_by_step(xsadd, (uint32_t)n);
+    } else {
+	xsadd_jump_back_u128(xsadd, 0, n);
+    }
+}
+
+void xsadd_fill_array_uint32_reverse(xsadd_t * xsadd, uint32_t array[],
+				     size_t size)
+{
+    if (size < REWIND_JUMP_THRESHOLD) {
+	for (size_t i = 0; i < size; i++) {
+	    array[i] = xsadd_uint32_prev(xsadd);
+	}
+	return;
+    }
+    xsadd_jump_back_u128(xsadd, 0, size);
+    xsadd_t work = *xsadd;
+    xsadd_fill_array_uint32(&work, array, size);
+    for (size_t i = 0, j = size - 1; i < j; i++, j--) {
+	uint32_t tmp = array[i];
+	array[i] = array[j];
+	array[j] = tmp;
+    }
+}
+
+void xsadd_jump_by_poly(xsadd_t * xsadd, const xsadd_jump_poly_t * jump_poly)
+{
+    uint32_t ar[4];
+    for (int i = 0; i < 2; i++) {
+	ar[2 * i] = (uint32_t)jump_poly->poly[i];
+	ar[2 * i + 1] = (uint32_t)(jump_poly->poly[i] >> 32);
+    }
+    jump_by_words(xsadd, ar, 4);
+}
+
+void xsadd_jump_poly_from_str(xsadd_jump_poly_t * jump_poly,
+			      const char * jump_str)
+{
+    f2_polynomial poly;
+    f2_poly128 jump128;
+    uint64_t x[4];
+    strtopolynomial(&poly, jump_str);
+    to64(x, &poly);
+    mod_phi(&jump128, x);
+    poly_from128(jump_poly, &jump128);
+}
+
+void xsadd_jump_poly_to_str(char * jump_str,
+			    const xsadd_jump_poly_t * jump_poly)
+{
+    f2_polynomial poly;
+    clear(&poly);
+    for (int i = 0; i < 2; i++) {
+	poly.ar[2 * i] = (uint32_t)jump_poly->poly[i];
+	poly.ar[2 * i + 1] = (uint32_t)(jump_poly->poly[i] >> 32);
+    }
+    polynomialtostr(jump_str, &poly);
+}
+
+void xsadd_jump_poly_mul(xsadd_jump_poly_t * dest,
+			 const xsadd_jump_poly_t * x,
+			 const xsadd_jump_poly_t * y)
+{
+    f2_poly128 a;
+    f2_poly128 b;
+    poly_to128(&a, x);
+    poly_to128(&b, y);
+    mul_mod_phi(&a, &b);
+    poly_from128(dest, &a);
+}
+
+void xsadd_jump_poly_pow(xsadd_jump_poly_t * dest,
+			 const xsadd_jump_poly_t * x,
+			 uint64_t e)
+{
+    f2_poly128 result;
+    f2_poly128 base;
+    result.ar[0] = 1;
+    result.ar[1] = 0;
+    poly_to128(&base, x);
+    while (e != 0) {
+	if ((e & 1) != 0) {
+	    mul_mod_phi(&result, &base);
+	}
+	e = e >> 1;
+	if (e != 0) {
+	    square_mod_phi(&base);
+	}
+    }
+    poly_from128(dest, &result);
+}
+
+void xsadd_spawn_streams(const xsadd_t * root, xsadd_t out[], size_t n,
+			 uint64_t step_hi, uint64_t step_lo)
+{
+    xsadd_jump_poly_t jump_poly;
+    if (n == 0) {
+	return;
+    }
+    xsadd_calculate_jump_poly_u128(&jump_poly, step_hi, step_lo);
+    xsadd_spawn_streams_by_poly(root, out, n, &jump_poly);
+}
+
+void xsadd_spawn_streams_by_poly(const xsadd_t * root, xsadd_t out[],
+				 size_t n,
+				 const xsadd_jump_poly_t * jump_poly)
+{
+    if (n == 0) {
+	return;
+    }
+    out[0] = *root;
+    for (size_t i = 1; i < n; i++) {
+	out[i] = out[i - 1];
+	xsadd_jump_by_poly(&out[i], jump_poly);
+    }
+}
+
+void xsadd_pos_init(xsadd_pos_t * xsadd_pos, uint32_t seed)
 {
-    char jump_str[200];
-    xsadd_calculate_jump_polynomial(jump_str, mul_step, base_step);
-    xsadd_jump_by_polynomial(xsadd, jump_str);
+    xsadd_t xsadd;
+    xsadd_init(&xsadd, seed);
+    xsadd_pos_init_by_xsadd(xsadd_pos, &xsadd);
 }
 
-/**
- * jump using the jump polynomial.
- * This function is not as time consuming as calculating jump polynomial.
- * This function can use multiple time for the xsadd structure.
- * @param xsadd xsadd structure, overwritten by new state after calling
- * this function.
- * @param jump_str the jump polynomial calculated by
- * xsadd_calculate_jump_polynomial.
- */
-void xsadd_jump_by_polynomial(xsadd_t *xsadd, const char * jump_str)
+void xsadd_pos_init_by_xsadd(xsadd_pos_t * xsadd_pos, const xsadd_t * xsadd)
 {
-    f2_polynomial jump_poly;
-    xsadd_t work_z;
-    xsadd_t * work = &work_z;
-    *work = *xsadd;
-    for (int i = 0; i < 4; i++) {
-        work->state[i] = 0;
+    xsadd_pos->xsadd = *xsadd;
+    xsadd_pos->origin = *xsadd;
+    xsadd_pos->pos_hi = 0;
+    xsadd_pos->pos_lo = 0;
+}
+
+void xsadd_pos_fill_array_uint32(xsadd_pos_t * xsadd_pos,
+				 uint32_t array[], size_t size)
+{
+    xsadd_fill_array_uint32(&xsadd_pos->xsadd, array, size);
+    xsadd_pos->pos_lo += size;
+    if (xsadd_pos->pos_lo < size) {
+	xsadd_pos->pos_hi++;
     }
-    strtopolynomial(&jump_poly, jump_str);
-    for (int i = 0; i < POLYNOMIAL_ARRAY_SIZE; i++) {
-	for (int j = 0; j < 32; j++) {
-	    uint32_t mask = 1 << j;
-	    if ((jump_poly.ar[i] & mask) != 0) {
-		xsadd_add(work, xsadd);
+}
+
+void xsadd_tell(const xsadd_pos_t * xsadd_pos,
+		uint64_t * pos_hi, uint64_t * pos_lo)
+{
+    *pos_hi = xsadd_pos->pos_hi;
+    *pos_lo = xsadd_pos->pos_lo;
+}
+
+void xsadd_seek(xsadd_pos_t * xsadd_pos, uint64_t pos_hi, uint64_t pos_lo)
+{
+    uint64_t cur_hi = xsadd_pos->pos_hi;
+    uint64_t cur_lo = xsadd_pos->pos_lo;
+    if (pos_hi > cur_hi || (pos_hi == cur_hi && pos_lo >= cur_lo)) {
+	uint64_t step_lo = pos_lo - cur_lo;
+	uint64_t step_hi = pos_hi - cur_hi - (pos_lo < cur_lo);
+	if (step_hi == 0) {
+	    xsadd_discard(&xsadd_pos->xsadd, step_lo);
+	} else {
+	    xsadd_jump_u128(&xsadd_pos->xsadd, step_hi, step_lo);
+	}
+    } else {
+	uint64_t back_lo = cur_lo - pos_lo;
+	uint64_t back_hi = cur_hi - pos_hi - (cur_lo < pos_lo);
+	if (back_hi < pos_hi || (back_hi == pos_hi && back_lo <= pos_lo)) {
+	    if (back_hi == 0) {
+		xsadd_rewind(&xsadd_pos->xsadd, back_lo);
+	    } else {
+		xsadd_jump_back_u128(&xsadd_pos->xsadd, back_hi, back_lo);
 	    }
-	    xsadd_next_state(xsadd);
+	} else {
+	    xsadd_pos->xsadd = xsadd_pos->origin;
+	    xsadd_jump_u128(&xsadd_pos->xsadd, pos_hi, pos_lo);
 	}
     }
-    *xsadd = *work;
+    xsadd_pos->pos_hi = pos_hi;
+    xsadd_pos->pos_lo = pos_lo;
 }
 
-void xsadd_calculate_jump_polynomial(char *jump_str,
-				     uint32_t mul_step,
-				     const char * base_step)
+uint32_t xsadd_at(const xsadd_t * xsadd, uint64_t index)
 {
-    f2_polynomial jump_poly;
-    f2_polynomial charcteristic;
-    f2_polynomial tee;
-    uz base;
-    uz mul;
-    uz step;
+    xsadd_t work = *xsadd;
+    xsadd_discard(&work, index);
+    return xsadd_uint32(&work);
+}
 
-    strtopolynomial(&charcteristic, characteristic_polynomial);
-    clear(&tee);
-    tee.ar[0] = 2;
-    string16touz(&base, base_step);
-    uint32touz(&mul, mul_step);
-    uz_mul(&step, &mul, &base);
-    polynomial_power_mod(&jump_poly, &tee, &step, &charcteristic);
-    polynomialtostr(jump_str, &jump_poly);
+void xsadd_at_many(const xsadd_t * xsadd, uint32_t out[],
+		   const uint64_t index[], size_t size)
+{
+    /* work is at position pos, not advanced by the output */
+    xsadd_t work = *xsadd;
+    uint64_t pos = 0;
+    for (size_t i = 0; i < size; i++) {
+	if (index[i] >= pos) {
+	    xsadd_discard(&work, index[i] - pos);
+	} else if (pos - index[i] <= index[i]) {
+	    xsadd_rewind(&work, pos - index[i]);
+	} else {
+	    work = *xsadd;
+	    xsadd_discard(&work, index[i]);
+	}
+	pos = index[i];
+	xsadd_t next = work;
+	out[i] = xsadd_uint32(&next);
+    }
 }
 
 /* ================
  * PRIVATE FUNCTIONS
    ================ */
+/**
+ * conversion from public jump polynomial to f2_poly128.
+ * @param dest polynomial
+ * @param jump_poly jump polynomial
+ */
+inline static void poly_to128(f2_poly128 * dest,
+			      const xsadd_jump_poly_t * jump_poly)
+{
+    dest->ar[0] = jump_poly->poly[0];
+    dest->ar[1] = jump_poly->poly[1];
+}
+
+/**
+ * conversion from f2_poly128 to public jump polynomial.
+ * @param jump_poly jump polynomial
+ * @param src polynomial
+ */
+inline static void poly_from128(xsadd_jump_poly_t * jump_poly,
+				const f2_poly128 * src)
+{
+    jump_poly->poly[0] = src->ar[0];
+    jump_poly->poly[1] = src->ar[1];
+}
+
 /**
  * Addition of internal state as F<sub>2</sub> vector.
  * @param dest destination
@@ -263,6 +1459,206 @@ static void xsadd_add(xsadd_t *dest, const xsadd_t *src)
     dest->state[3] ^= src->state[3];
 }
 
+/**
+ * advance the state by n steps one by one.
+ * @param xsadd xsadd internal state
+ * @param n number of steps
+ */
+static void discard_by_step(xsadd_t * xsadd, uint32_t n)
+{
+    uint32_t s0 = xsadd->state[0];
+    uint32_t s1 = xsadd->state[1];
+    uint32_t s2 = xsadd->state[2];
+    uint32_t s3 = xsadd->state[3];
+    uint32_t t;
+    for (; n >= 4; n -= 4) {
+	t = s0 ^ (s0 << SH1);
+	s0 = t ^ (t >> SH2) ^ (s3 << SH3);
+	t = s1 ^ (s1 << SH1);
+	s1 = t ^ (t >> SH2) ^ (s0 << SH3);
+	t = s2 ^ (s2 << SH1);
+	s2 = t ^ (t >> SH2) ^ (s1 << SH3);
+	t = s3 ^ (s3 << SH1);
+	s3 = t ^ (t >> SH2) ^ (s2 << SH3);
+    }
+    xsadd->state[0] = s0;
+    xsadd->state[1] = s1;
+    xsadd->state[2] = s2;
+    xsadd->state[3] = s3;
+    for (; n > 0; n--) {
+	xsadd_next_state(xsadd);
+    }
+}
+
+/**
+ * change the state back by n steps one by one.
+ * @param xsadd xsadd internal state
+ * @param n number of steps
+ */
+static void rewind_by_step(xsadd_t * xsadd, uint32_t n)
+{
+    uint32_t s0 = xsadd->state[0];
+    uint32_t s1 = xsadd->state[1];
+    uint32_t s2 = xsadd->state[2];
+    uint32_t s3 = xsadd->state[3];
+    uint32_t t;
+    for (; n >= 4; n -= 4) {
+	t = s3 ^ (s2 << SH3);
+	t ^= t >> SH2;
+	s3 = t ^ (t << SH1) ^ (t << (2 * SH1));
+	t = s2 ^ (s1 << SH3);
+	t ^= t >> SH2;
+	s2 = t ^ (t << SH1) ^ (t << (2 * SH1));
+	t = s1 ^ (s0 << SH3);
+	t ^= t >> SH2;
+	s1 = t ^ (t << SH1) ^ (t << (2 * SH1));
+	t = s0 ^ (s3 << SH3);
+	t ^= t >> SH2;
+	s0 = t ^ (t << SH1) ^ (t << (2 * SH1));
+    }
+    xsadd->state[0] = s0;
+    xsadd->state[1] = s1;
+    xsadd->state[2] = s2;
+    xsadd->state[3] = s3;
+    for (; n > 0; n--) {
+	xsadd_prev_state(xsadd);
+    }
+}
+
+/**
+ * make the sequence of state words.
+ * The state after k steps is (seq[k], seq[k + 1], seq[k + 2],
+ * seq[k + 3]).
+ * @param seq output, needs size + 4 elements
+ * @param xsadd xsadd internal state
+ * @param size number of steps, a multiple of 4
+ */
+static void state_sequence(uint32_t seq[], const xsadd_t * xsadd, int size)
+{
+    uint32_t s0 = xsadd->state[0];
+    uint32_t s1 = xsadd->state[1];
+    uint32_t s2 = xsadd->state[2];
+    uint32_t s3 = xsadd->state[3];
+    uint32_t t;
+    seq[0] = s0;
+    seq[1] = s1;
+    seq[2] = s2;
+    seq[3] = s3;
+    for (int i = 4; i < size + 4; i += 4) {
+	t = s0 ^ (s0 << SH1);
+	s0 = t ^ (t >> SH2) ^ (s3 << SH3);
+	seq[i] = s0;
+	t = s1 ^ (s1 << SH1);
+	s1 = t ^ (t >> SH2) ^ (s0 << SH3);
+	seq[i + 1] = s1;
+	t = s2 ^ (s2 << SH1);
+	s2 = t ^ (t >> SH2) ^ (s1 << SH3);
+	seq[i + 2] = s2;
+	t = s3 ^ (s3 << SH1);
+	s3 = t ^ (t >> SH2) ^ (s2 << SH3);
+	seq[i + 3] = s3;
+    }
+}
+
+/**
+ * sum of c<sub>i</sub> (seq[i], ..., seq[i + 3]), portable version.
+ * @param result the sum
+ * @param seq sequence of state words
+ * @param poly coefficients c<sub>i</sub>
+ * @param size number of 32-bit words of poly
+ */
+static void masked_sum_generic(uint32_t result[4], const uint32_t seq[],
+			       const uint32_t poly[], int size)
+{
+    uint32_t acc[4] = {0, 0, 0, 0};
+    for (int i = 0; i < size * 32; i++) {
+	uint32_t mask = -((poly[i / 32] >> (i % 32)) & 1);
+	acc[0] ^= seq[i] & mask;
+	acc[1] ^= seq[i + 1] & mask;
+	acc[2] ^= seq[i + 2] & mask;
+	acc[3] ^= seq[i + 3] & mask;
+    }
+    for (int i = 0; i < 4; i++) {
+	result[i] = acc[i];
+    }
+}
+
+#if defined(XSADD_X86_KERNELS)
+/**
+ * sum of c<sub>i</sub> (seq[i], ..., seq[i + 3]), SSE2 version.
+ * Four accumulators are used to hide the latency.
+ * @param result the sum
+ * @param seq sequence of state words
+ * @param poly coefficients c<sub>i</sub>
+ * @param size number of 32-bit words of poly
+ */
+__attribute__((target("sse2")))
+static void masked_sum_sse2(uint32_t result[4], const uint32_t seq[],
+			    const uint32_t poly[], int size)
+{
+    __m128i acc[4];
+    for (int k = 0; k < 4; k++) {
+	acc[k] = _mm_setzero_si128();
+    }
+    for (int w = 0; w < size; w++) {
+	const uint32_t * s = &seq[w * 32];
+	uint32_t c = poly[w];
+	for (int j = 0; j < 32; j += 4) {
+	    for (int k = 0; k < 4; k++) {
+		__m128i mask = _mm_set1_epi32(-((c >> (j + k)) & 1));
+		__m128i x = _mm_loadu_si128((const __m128i *)&s[j + k]);
+		acc[k] = _mm_xor_si128(acc[k], _mm_and_si128(x, mask));
+	    }
+	}
+    }
+    acc[0] = _mm_xor_si128(_mm_xor_si128(acc[0], acc[1]),
+			   _mm_xor_si128(acc[2], acc[3]));
+    _mm_storeu_si128((__m128i *)result, acc[0]);
+}
+#endif
+
+/**
+ * jump using the jump polynomial p(t) = sum of c<sub>i</sub>
+ * t<sup>i</sup>.
+ * If s<sub>0</sub>, s<sub>1</sub>, ... is the sequence of state words,
+ * i.e. the state after k steps is (s<sub>k</sub>, ..., s<sub>k+3</sub>),
+ * the state after jump is the sum of c<sub>i</sub>
+ * (s<sub>i</sub>, ..., s<sub>i+3</sub>). So the words are generated
+ * once, and the sum is taken by masking without branch.
+ * @param xsadd xsadd structure, overwritten by new state after calling
+ * this function.
+ * @param poly coefficients of the jump polynomial, poly[0] & 1 is the
+ * constant.
+ * @param size number of 32-bit words of poly, at most
+ * POLYNOMIAL_ARRAY_SIZE.
+ */
+static void jump_by_words(xsadd_t * xsadd, const uint32_t poly[], int size)
+{
+    uint32_t seq[POLYNOMIAL_ARRAY_SIZE * 32 + 4];
+    while (size > 0 && poly[size - 1] == 0) {
+	size--;
+    }
+    state_sequence(seq, xsadd, size * 32);
+#if defined(XSADD_X86_KERNELS)
+    if (sse2_supported()) {
+	masked_sum_sse2(xsadd->state, seq, poly, size);
+	return;
+    }
+#endif
+    masked_sum_generic(xsadd->state, seq, poly, size);
+}
+
+/**
+ * jump using the jump polynomial of 256 bits.
+ * @param xsadd xsadd structure, overwritten by new state after calling
+ * this function.
+ * @param jump_poly the jump polynomial
+ */
+static void jump_by_f2(xsadd_t * xsadd, const f2_polynomial * jump_poly)
+{
+    jump_by_words(xsadd, jump_poly->ar, POLYNOMIAL_ARRAY_SIZE);
+}
+
 static void period_certification(xsadd_t * xsadd)
 {
     if (xsadd->state[0] == 0 &&
@@ -302,21 +1698,6 @@ inline static void clear(f2_polynomial * dest)
     }
 }
 
-/**
- * shift up 1 bit, if　indeterminate of dest is <b>t</b>
- * dest = dest * <b>t</b>
- * @param dest 256-bit polynomial
- */
-inline static void shiftup1(f2_polynomial *dest)
-{
-    uint32_t lsb = 0;
-    for (int i = 0; i < POLYNOMIAL_ARRAY_SIZE; i++) {
-	uint32_t tmp = dest->ar[i] >> 31;
-	dest->ar[i] = (dest->ar[i] << 1) | lsb;
-	lsb = tmp;
-    }
-}
-
 /**
  * shift up n bit, if　indeterminate of dest is <b>t</b>
  * dest = dest * <b>t<sup>n</sup></b>
@@ -445,41 +1826,635 @@ inline static uint32_t ini_func2(uint32_t x)
     return (x ^ (x >> 27)) * UINT32_C(1566083941);
 }
 
+/**
+ * carry-less multiplication of 64-bit polynomials, portable version.
+ * The product is calculated by 4-bit window, and the top three bits
+ * of a, which overflow the window table, are added separately.
+ * @param r r[0] is lower 64-bit and r[1] is upper 64-bit of a * b
+ * @param a polynomial
+ * @param b polynomial
+ */
+static void clmul64_generic(uint64_t r[2], uint64_t a, uint64_t b)
+{
+    uint64_t tab[16];
+    uint64_t hi = 0;
+    uint64_t lo;
+    tab[0] = 0;
+    tab[1] = a & UINT64_C(0x1fffffffffffffff);
+    for (int i = 2; i < 16; i += 2) {
+	tab[i] = tab[i / 2] << 1;
+	tab[i + 1] = tab[i] ^ tab[1];
+    }
+    lo = tab[b >> 60];
+    for (int i = 56; i >= 0; i -= 4) {
+	hi = (hi << 4) | (lo >> 60);
+	lo = (lo << 4) ^ tab[(b >> i) & 15];
+    }
+    for (int j = 61; j < 64; j++) {
+	uint64_t mask = -((a >> j) & 1);
+	lo ^= (b << j) & mask;
+	hi ^= (b >> (64 - j)) & mask;
+    }
+    r[0] = lo;
+    r[1] = hi;
+}
+
+/**
+ * carry-less multiplication of 128-bit polynomials, portable version.
+ * Karatsuba method, three 64-bit multiplications.
+ * @param r 256-bit product, r[0] is the lowest
+ * @param a 128-bit polynomial
+ * @param b 128-bit polynomial
+ */
+static void clmul128_generic(uint64_t r[4], const uint64_t a[2],
+			     const uint64_t b[2])
+{
+    uint64_t lo[2];
+    uint64_t hi[2];
+    uint64_t mid[2];
+    clmul64_generic(lo, a[0], b[0]);
+    clmul64_generic(hi, a[1], b[1]);
+    clmul64_generic(mid, a[0] ^ a[1], b[0] ^ b[1]);
+    mid[0] ^= lo[0] ^ hi[0];
+    mid[1] ^= lo[1] ^ hi[1];
+    r[0] = lo[0];
+    r[1] = lo[1] ^ mid[0];
+    r[2] = hi[0] ^ mid[1];
+    r[3] = hi[1];
+}
+
+#if defined(XSADD_X86_KERNELS)
+/**
+ * carry-less multiplication of 128-bit polynomials using PCLMULQDQ.
+ * @param r 256-bit product, r[0] is the lowest
+ * @param a 128-bit polynomial
+ * @param b 128-bit polynomial
+ */
+__attribute__((target("sse2,pclmul")))
+static void clmul128_pclmul(uint64_t r[4], const uint64_t a[2],
+			    const uint64_t b[2])
+{
+    __m128i x = _mm_loadu_si128((const __m128i *)a);
+    __m128i y = _mm_loadu_si128((const __m128i *)b);
+    __m128i lo = _mm_clmulepi64_si128(x, y, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(x, y, 0x11);
+    __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(x, y, 0x01),
+				_mm_clmulepi64_si128(x, y, 0x10));
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+    _mm_storeu_si128((__m128i *)&r[0], lo);
+    _mm_storeu_si128((__m128i *)&r[2], hi);
+}
+
+static int pclmul_supported(void)
+{
+    return __builtin_cpu_supports("pclmul");
+}
+#endif
+
+/**
+ * carry-less multiplication of 128-bit polynomials.
+ * PCLMULQDQ is used if the CPU supports it.
+ * @param r 256-bit product, r[0] is the lowest
+ * @param a 128-bit polynomial
+ * @param b 128-bit polynomial
+ */
+static void clmul128(uint64_t r[4], const uint64_t a[2], const uint64_t b[2])
+{
+#if defined(XSADD_X86_KERNELS)
+    if (pclmul_supported()) {
+	clmul128_pclmul(r, a, b);
+	return;
+    }
+#endif
+    clmul128_generic(r, a, b);
+}
+
+/**
+ * spread 32 bits to even bits of 64 bits, that is, square of 32-bit
+ * polynomial.
+ * @param x 32-bit polynomial
+ * @return x * x
+ */
+inline static uint64_t spread32(uint32_t x)
+{
+    uint64_t y = x;
+    y = (y | (y << 16)) & UINT64_C(0x0000ffff0000ffff);
+    y = (y | (y << 8)) & UINT64_C(0x00ff00ff00ff00ff);
+    y = (y | (y << 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+    y = (y | (y << 2)) & UINT64_C(0x3333333333333333);
+    y = (y | (y << 1)) & UINT64_C(0x5555555555555555);
+    return y;
+}
+
+/**
+ * conversion from 256-bit polynomial to array of 64-bit integers.
+ * @param dest dest[0] is the lowest 64 bits
+ * @param x polynomial
+ */
+inline static void to64(uint64_t dest[4], const f2_polynomial * x)
+{
+    for (int i = 0; i < 4; i++) {
+	dest[i] = x->ar[2 * i] | ((uint64_t)x->ar[2 * i + 1] << 32);
+    }
+}
+
+/**
+ * conversion from array of 64-bit integers to 256-bit polynomial.
+ * @param dest polynomial
+ * @param x x[0] is the lowest 64 bits
+ */
+inline static void from64(f2_polynomial * dest, const uint64_t x[4])
+{
+    for (int i = 0; i < 4; i++) {
+	dest->ar[2 * i] = (uint32_t)x[i];
+	dest->ar[2 * i + 1] = (uint32_t)(x[i] >> 32);
+    }
+}
+
 /**
  * multiplication of polynomials
  * y's degree is assumed to be lower than 128 <br>
  * x = x * y
+ * The product is truncated to 256 bits.
  * @param x polynomial
  * @param y polynomial
  */
 static void mul(f2_polynomial *x, const f2_polynomial *y)
 {
-    f2_polynomial result_z;
-    f2_polynomial *result = &result_z;
-    clear(result);
-    for (int i = 0; i < POLYNOMIAL_ARRAY_SIZE; i++) {
-	uint32_t u = y->ar[i];
-	for (int j = 0; j < 32; j++) {
-	    if ((u & 1) != 0) {
-		add(result, x);
-	    }
-	    shiftup1(x);
-	    u = u >> 1;
-	}
+    uint64_t a[4];
+    uint64_t b[4];
+    uint64_t r[4];
+    uint64_t cross[4];
+    to64(a, x);
+    to64(b, y);
+    clmul128(r, &a[0], &b[0]);
+    if ((a[2] | a[3]) != 0) {
+	clmul128(cross, &a[2], &b[0]);
+	r[2] ^= cross[0];
+	r[3] ^= cross[1];
+    }
+    if ((b[2] | b[3]) != 0) {
+	clmul128(cross, &a[0], &b[2]);
+	r[2] ^= cross[0];
+	r[3] ^= cross[1];
     }
-    *x = *result;
+    from64(x, r);
 }
 
 /**
  * square polynomial <br>
  * x = x * x
+ * Square over F<sub>2</sub> is spreading bits, and the product is
+ * truncated to 256 bits.
  * @param x polynomial
  */
 static void square(f2_polynomial *x)
 {
-    f2_polynomial tmp;
-    tmp = *x;
-    mul(x, &tmp);
+    uint64_t r[4];
+    for (int i = 0; i < 4; i++) {
+	r[i] = spread32(x->ar[i]);
+    }
+    from64(x, r);
+}
+
+/**
+ * add 128-bit polynomial multiplied by t<sup>e</sup> to 256-bit
+ * polynomial.
+ * x = x + h * t<sup>e</sup>
+ * @param x 256-bit polynomial, x[0] is the lowest
+ * @param h0 lower 64 bits of h
+ * @param h1 upper 64 bits of h
+ * @param e exponent, 0 <= e < 128
+ */
+inline static void add_shifted(uint64_t x[4], uint64_t h0, uint64_t h1,
+			       int e)
+{
+    int q = e / 64;
+    int r = e % 64;
+    x[q] ^= h0 << r;
+    x[q + 1] ^= h1 << r;
+    if (r != 0) {
+	x[q + 1] ^= h0 >> (64 - r);
+	x[q + 2] ^= h1 >> (64 - r);
+    }
+}
+
+/**
+ * remainder of polynomial divided by the characteristic polynomial.
+ * The characteristic polynomial is t<sup>128</sup> + sum of
+ * t<sup>e</sup> for e = 0, 39, 40, 44, 48, 50, 55, 66, 71, 72, 80, 87.
+ * Using this, the upper 128 bits h are folded into
+ * h * sum of t<sup>e</sup>, word by word. As the largest e is 87, each
+ * folding lowers the degree by 40 or more, and at most four foldings
+ * are needed.
+ * @param dest the remainder
+ * @param x 256-bit polynomial, x[0] is the lowest
+ */
+static void mod_phi(f2_poly128 * dest, const uint64_t x[4])
+{
+    uint64_t w[4];
+    for (int i = 0; i < 4; i++) {
+	w[i] = x[i];
+    }
+    while ((w[2] | w[3]) != 0) {
+	uint64_t h0 = w[2];
+	uint64_t h1 = w[3];
+	w[2] = 0;
+	w[3] = 0;
+	add_shifted(w, h0, h1, 0);
+	add_shifted(w, h0, h1, 39);
+	add_shifted(w, h0, h1, 40);
+	add_shifted(w, h0, h1, 44);
+	add_shifted(w, h0, h1, 48);
+	add_shifted(w, h0, h1, 50);
+	add_shifted(w, h0, h1, 55);
+	add_shifted(w, h0, h1, 66);
+	add_shifted(w, h0, h1, 71);
+	add_shifted(w, h0, h1, 72);
+	add_shifted(w, h0, h1, 80);
+	add_shifted(w, h0, h1, 87);
+    }
+    dest->ar[0] = w[0];
+    dest->ar[1] = w[1];
+}
+
+/**
+ * multiplication modulo the characteristic polynomial.
+ * x = x * y % characteristic_polynomial
+ * @param x polynomial
+ * @param y polynomial
+ */
+inline static void mul_mod_phi(f2_poly128 * x, const f2_poly128 * y)
+{
+    uint64_t r[4];
+    clmul128(r, x->ar, y->ar);
+    mod_phi(x, r);
+}
+
+/**
+ * square modulo the characteristic polynomial.
+ * x = x * x % characteristic_polynomial
+ * @param x polynomial
+ */
+inline static void square_mod_phi(f2_poly128 * x)
+{
+    uint64_t r[4];
+    for (int i = 0; i < 2; i++) {
+	r[2 * i] = spread32((uint32_t)x->ar[i]);
+	r[2 * i + 1] = spread32((uint32_t)(x->ar[i] >> 32));
+    }
+    mod_phi(x, r);
+}
+
+/**
+ * jump_table[i] = t<sup>2<sup>i</sup></sup> % characteristic_polynomial.
+ * The table is made by squaring t modulo the characteristic
+ * polynomial 127 times, using square_mod_phi().
+ */
+static const f2_poly128 jump_table[128] = {
+    {{UINT64_C(0x0000000000000002), UINT64_C(0x0000000000000000)}},
+    {{UINT64_C(0x0000000000000004), UINT64_C(0x0000000000000000)}},
+    {{UINT64_C(0x0000000000000010), UINT64_C(0x0000000000000000)}},
+    {{UINT64_C(0x0000000000000100), UINT64_C(0x0000000000000000)}},
+    {{UINT64_C(0x0000000000010000), UINT64_C(0x0000000000000000)}},
+    {{UINT64_C(0x0000000100000000), UINT64_C(0x0000000000000000)}},
+    {{UINT64_C(0x0000000000000000), UINT64_C(0x0000000000000001)}},
+    {{UINT64_C(0x0085118000000001), UINT64_C(0x0000000000810184)}},
+    {{UINT64_C(0x4d13680100014031), UINT64_C(0x40e041151c3179e4)}},
+    {{UINT64_C(0xdd4c152ac9637018), UINT64_C(0xf19cd49004e81e31)}},
+    {{UINT64_C(0x083b318675ecfd38), UINT64_C(0x84435defa555c484)}},
+    {{UINT64_C(0x243f968ac89d8901), UINT64_C(0x5052ad5efa685e0b)}},
+    {{UINT64_C(0x892207fec1c9e6c9), UINT64_C(0x25f906fa2697b4a0)}},
+    {{UINT64_C(0x33b7b1d3054342dc), UINT64_C(0xafc68d02039814b7)}},
+    {{UINT64_C(0x15e75f3b4b18364c), UINT64_C(0x16e09e09f5e1cc72)}},
+    {{UINT64_C(0x9859d8cf45f41761), UINT64_C(0x3533e81bccf6f4f2)}},
+    {{UINT64_C(0xb53ad2ea98d47828), UINT64_C(0x869e028b4630a19b)}},
+    {{UINT64_C(0x24e92065d1cc94e2), UINT64_C(0xad28ce21ba7c6c44)}},
+    {{UINT64_C(0x2825a00f375fa9df), UINT64_C(0xeeef1d52cba8726f)}},
+    {{UINT64_C(0x9c8aee986b4f23c8), UINT64_C(0xf3a678de76bcdbe2)}},
+    {{UINT64_C(0x20cb05fe928f9e10), UINT64_C(0x99f5ce22a1a3c87e)}},
+    {{UINT64_C(0x02fb30704133a162), UINT64_C(0x47290b8ceb68b7fc)}},
+    {{UINT64_C(0x1fe9b07b24994c93), UINT64_C(0x5adc647ed1f2b88f)}},
+    {{UINT64_C(0xe8be8fa0b8558f94), UINT64_C(0x9d7bf860ccf691a9)}},
+    {{UINT64_C(0x33656b9aae532eaf), UINT64_C(0x79671893e6278216)}},
+    {{UINT64_C(0x6fd950718cc5371f), UINT64_C(0xca131f003c467395)}},
+    {{UINT64_C(0x0cf523fc1b439104), UINT64_C(0x44237ec4234999c8)}},
+    {{UINT64_C(0xb660fb7cecb7e73b), UINT64_C(0x97585432debc60d8)}},
+    {{UINT64_C(0x6a6955b224fe4519), UINT64_C(0x3fc800440e3fedf9)}},
+    {{UINT64_C(0xbf63aa2696b1125e), UINT64_C(0x660dfd4121c2c994)}},
+    {{UINT64_C(0x95447cf88ea1954f), UINT64_C(0x7d53f109762b32b0)}},
+    {{UINT64_C(0x0571ecacdf79adb1), UINT64_C(0xb2a5297ded41f874)}},
+    {{UINT64_C(0x7ad7b2881681ed36), UINT64_C(0x10a0811c10cd130d)}},
+    {{UINT64_C(0x9f3846423d866889), UINT64_C(0x3071b30ad2ff14bb)}},
+    {{UINT64_C(0x92a470bbe401b764), UINT64_C(0x69021385c61ba8e8)}},
+    {{UINT64_C(0x7bfce5ffedcdd34f), UINT64_C(0xebc73c449b0790de)}},
+    {{UINT64_C(0x8e9d549ccd175d34), UINT64_C(0xd4d69cda63ee003d)}},
+    {{UINT64_C(0xc9a67f5c587f87b6), UINT64_C(0x44e5061c4055b566)}},
+    {{UINT64_C(0xae43f9f2a6f3bf96), UINT64_C(0x2da73079d7ee2551)}},
+    {{UINT64_C(0x107c8fe90682e19b), UINT64_C(0x5f343ca755ab1f0a)}},
+    {{UINT64_C(0x7e258cae907be659), UINT64_C(0x62773949b6571ec8)}},
+    {{UINT64_C(0x42700a8b0cf394a2), UINT64_C(0x0538ba6e0f0d0348)}},
+    {{UINT64_C(0xbbdef5ae74be53a8), UINT64_C(0x893a8c62c12801da)}},
+    {{UINT64_C(0xa8d35d8cbcc09d9c), UINT64_C(0x42f9b32dc5c1a39b)}},
+    {{UINT64_C(0x3539c6c25ca60633), UINT64_C(0xf7e5dddf44c84a7e)}},
+    {{UINT64_C(0x83a18090916342ef), UINT64_C(0xc88e4ac8471cbeff)}},
+    {{UINT64_C(0x9c36bafc4d4d76f6), UINT64_C(0xb8e95e6fcdf7458e)}},
+    {{UINT64_C(0xf1c7678f1011899c), UINT64_C(0x8bb0142d01a05882)}},
+    {{UINT64_C(0x4830dc151224716d), UINT64_C(0xfde81200e29877c2)}},
+    {{UINT64_C(0x949fa6154b95e100), UINT64_C(0xde0ae66df49aacf5)}},
+    {{UINT64_C(0xae1ab199aedadda5), UINT64_C(0x7711e699344b9008)}},
+    {{UINT64_C(0x0427c804a0c8f347), UINT64_C(0xa2f396653d3a2b66)}},
+    {{UINT64_C(0x7e2bb4764647ace6), UINT64_C(0x49b806d07590583c)}},
+    {{UINT64_C(0xb552cd435ed0b391), UINT64_C(0xcfbcf93b1a9f4134)}},
+    {{UINT64_C(0xd3fce16294ca5c43), UINT64_C(0x452025bf79a8761e)}},
+    {{UINT64_C(0x5dfd95fbaeec43da), UINT64_C(0x71fa7f90a306f2d9)}},
+    {{UINT64_C(0x9c2d2a1f5832cf5e), UINT64_C(0xc75a97b2dab481d0)}},
+    {{UINT64_C(0x9412c066e07609d6), UINT64_C(0x3508cd200400a674)}},
+    {{UINT64_C(0x49063af9957b10ff), UINT64_C(0x82d32493fc76da51)}},
+    {{UINT64_C(0xb2ea612f1b74b15a), UINT64_C(0xf80e74c336f5b9d0)}},
+    {{UINT64_C(0x32739dcd00a03bd1), UINT64_C(0x2007f321f36e70b7)}},
+    {{UINT64_C(0xf4a7013fc9924b09), UINT64_C(0xfaaeebb31f8dfc97)}},
+    {{UINT64_C(0x3a5c19902d3f74a3), UINT64_C(0xcbd128dade569f9d)}},
+    {{UINT64_C(0xbed2d13e753aad81), UINT64_C(0xabe427d609709fe7)}},
+    {{UINT64_C(0x7bacae76fe10e86d), UINT64_C(0xad97ad554a3f3aa8)}},
+    {{UINT64_C(0xeac2a1bc16464cfd), UINT64_C(0xa3d7374b2af69f53)}},
+    {{UINT64_C(0x6bc553d1356555ef), UINT64_C(0x90c5c0e6d8d02ea2)}},
+    {{UINT64_C(0x2295929ec387e69f), UINT64_C(0x0b0aa63900d2c6f2)}},
+    {{UINT64_C(0x6ebc69b4fb318d89), UINT64_C(0x30734f57e74d0d7e)}},
+    {{UINT64_C(0xf1a0391ca7e52867), UINT64_C(0x223f0096dd68aaae)}},
+    {{UINT64_C(0x15a3a0f472dadc43), UINT64_C(0xc72718c4909abb2d)}},
+    {{UINT64_C(0x63e34982e94a66f2), UINT64_C(0x8c9d07765ee9539f)}},
+    {{UINT64_C(0x9141a11e4523d730), UINT64_C(0x1544cf136483c793)}},
+    {{UINT64_C(0x496841e529aff813), UINT64_C(0x95e16e06c71cf7e5)}},
+    {{UINT64_C(0x764da381b9192e3a), UINT64_C(0xa5800dce7dfe4057)}},
+    {{UINT64_C(0x315efabb4f46aa51), UINT64_C(0xc357a63dc10e7287)}},
+    {{UINT64_C(0xe9de8c856fc47cd2), UINT64_C(0xdce430958f0dd19d)}},
+    {{UINT64_C(0x2f707a25acb97e08), UINT64_C(0x65854b4903841013)}},
+    {{UINT64_C(0x94f4da6f03304d37), UINT64_C(0x9a8d638a1e93140b)}},
+    {{UINT64_C(0x524cacabbe5ab312), UINT64_C(0x30a5526a37167cee)}},
+    {{UINT64_C(0xac71f33768e33655), UINT64_C(0x048c3dee38aba0e0)}},
+    {{UINT64_C(0x11927108b68a4ed8), UINT64_C(0x1775a9915baaa94e)}},
+    {{UINT64_C(0x0791175ca611ca79), UINT64_C(0x031f6a8439e211ac)}},
+    {{UINT64_C(0x2c4fb1bb97696152), UINT64_C(0x8d6d538917ff5ffd)}},
+    {{UINT64_C(0xf794b902a663100f), UINT64_C(0x9d181297a254b4b5)}},
+    {{UINT64_C(0xb5bef8854103afd7), UINT64_C(0xe9e0670f21005012)}},
+    {{UINT64_C(0xe07f804a41a37587), UINT64_C(0xe8c0d3dd06808c7c)}},
+    {{UINT64_C(0xa2540a135a6d747a), UINT64_C(0xa85323e3ed0ac937)}},
+    {{UINT64_C(0x5f300fd2f28eff4f), UINT64_C(0xc780b16ac4549d7e)}},
+    {{UINT64_C(0xf8ab1c35bc24aa97), UINT64_C(0x705156de744b6c64)}},
+    {{UINT64_C(0x2dc5287334a679b0), UINT64_C(0x3efb69ea186133f6)}},
+    {{UINT64_C(0x8364a5dc5f0e412f), UINT64_C(0x5cabe9252a73ea3e)}},
+    {{UINT64_C(0x02c09292f3cd3da2), UINT64_C(0xa7a280a40b6b8638)}},
+    {{UINT64_C(0x1cc3c78701b56890), UINT64_C(0xdaca4aeb3e841fbe)}},
+    {{UINT64_C(0x217617a691c8d89f), UINT64_C(0x9e74e8259612d241)}},
+    {{UINT64_C(0xee0f75160fd67a91), UINT64_C(0x4a25b5072ab89560)}},
+    {{UINT64_C(0x4fd1583cf8f7f9d5), UINT64_C(0x5d9ae8e063f5deee)}},
+    {{UINT64_C(0x2c981bed2bea84f7), UINT64_C(0x8150cf301841f865)}},
+    {{UINT64_C(0xcdd3af066f629fab), UINT64_C(0x5b6be559f194b052)}},
+    {{UINT64_C(0x80d7226179174e2e), UINT64_C(0xd8187ab37377e9c0)}},
+    {{UINT64_C(0x2c36ae0425a31262), UINT64_C(0x01ab1a440fe2c6b4)}},
+    {{UINT64_C(0xd309bffe996bb677), UINT64_C(0xc3b7b28b2c21623d)}},
+    {{UINT64_C(0x6471751928b21259), UINT64_C(0x98f4e8ba4c698c43)}},
+    {{UINT64_C(0x16c52256af2f6353), UINT64_C(0xe7a2e8c1c27d2463)}},
+    {{UINT64_C(0x4122f4db694860ab), UINT64_C(0x5880febbad702032)}},
+    {{UINT64_C(0xb3202ff4f9da3022), UINT64_C(0x980ec21b90b877aa)}},
+    {{UINT64_C(0x3742d5cc7f9c0fb3), UINT64_C(0xf9f0cae0eaf8a22e)}},
+    {{UINT64_C(0x888e7f124293d04c), UINT64_C(0x191379ff844764b8)}},
+    {{UINT64_C(0xb5d4c9f03915c4dc), UINT64_C(0x20fc1c53e1897654)}},
+    {{UINT64_C(0x9c900b24979cd302), UINT64_C(0xda9503b94f5bdec2)}},
+    {{UINT64_C(0x1bef7bbfcccf5179), UINT64_C(0x16e17f0d8df11a7d)}},
+    {{UINT64_C(0xc40c95a059c5fa00), UINT64_C(0x0c914a43c9b7807f)}},
+    {{UINT64_C(0xb8b0d374890dc4cf), UINT64_C(0x80abefebb98f04b3)}},
+    {{UINT64_C(0x2e94dad32a859a0e), UINT64_C(0xd21c7d312737a033)}},
+    {{UINT64_C(0x237d7134175aced7), UINT64_C(0xdcc69c372d6f5c6a)}},
+    {{UINT64_C(0x6e064f72919d5175), UINT64_C(0x4faee075fc5acb55)}},
+    {{UINT64_C(0x764f2d9a992c4ec1), UINT64_C(0x9d661f96845dc541)}},
+    {{UINT64_C(0xb70b761ad30a27d5), UINT64_C(0xbe2e62740c8baa30)}},
+    {{UINT64_C(0xf90fea204e429c39), UINT64_C(0x6f363bd1cbe529e0)}},
+    {{UINT64_C(0xc16112e287d49ffe), UINT64_C(0xc395cc8cce5246a2)}},
+    {{UINT64_C(0xe842e4909e55f6f7), UINT64_C(0xfcc7ef28533f1497)}},
+    {{UINT64_C(0xd45d697ff858d6ad), UINT64_C(0xcce7c0e6afb1dfb6)}},
+    {{UINT64_C(0xfaf00614288a3f08), UINT64_C(0xbe3bbb40115088a0)}},
+    {{UINT64_C(0x33ac9d9aef3dc4bb), UINT64_C(0x09caccb5957603dc)}},
+    {{UINT64_C(0x2629dea6b7530e65), UINT64_C(0xeb27adcfccf811b7)}},
+    {{UINT64_C(0xbd7924772f703596), UINT64_C(0x47fa1aef93ba880b)}},
+    {{UINT64_C(0xa7dd98cd7570ed2e), UINT64_C(0xaef99aa641f931f0)}},
+    {{UINT64_C(0x483f9fda36f00c68), UINT64_C(0x86a2260286c1d174)}}
+};
+
+/**
+ * back_jump_table[i] = t<sup>-2<sup>i</sup></sup> % characteristic_polynomial.
+ * t<sup>-1</sup> = t<sup>2<sup>128</sup>-2</sup> because the period is
+ * 2<sup>128</sup>-1, and the table is made by squaring it 127 times,
+ * using square_mod_phi().
+ */
+static const f2_poly128 back_jump_table[128] = {
+    {{UINT64_C(0x004288c000000000), UINT64_C(0x80000000004080c2)}},
+    {{UINT64_C(0x0021446000000000), UINT64_C(0x4000000000204061)}},
+    {{UINT64_C(0x4008511800000000), UINT64_C(0x1000000000081018)}},
+    {{UINT64_C(0x8400851180000000), UINT64_C(0x0100000000008101)}},
+    {{UINT64_C(0x0184008511800000), UINT64_C(0x0001000000000081)}},
+    {{UINT64_C(0x0081018400851180), UINT64_C(0x0000000100000000)}},
+    {{UINT64_C(0x140d461101804184), UINT64_C(0x008511800000420c)}},
+    {{UINT64_C(0x0f9cb6459950cc24), UINT64_C(0xd5e0401101ea64f8)}},
+    {{UINT64_C(0xcfdf620e0967903d), UINT64_C(0x9568958c4d562922)}},
+    {{UINT64_C(0x25d7163b5906bc0d), UINT64_C(0x3568d9e04c263d5b)}},
+    {{UINT64_C(0xd1fa61de1d40ac98), UINT64_C(0x61836d62fd5f388c)}},
+    {{UINT64_C(0x9d7d92fe6c9f85f0), UINT64_C(0xf88e646f1691248d)}},
+    {{UINT64_C(0x4527741af8b4c6fa), UINT64_C(0x91556ba9db5a67e3)}},
+    {{UINT64_C(0xb8c187555e096815), UINT64_C(0x36d6ac5828a7c7b7)}},
+    {{UINT64_C(0x88ba4ec5c910260a), UINT64_C(0x05198f45dd0dcee3)}},
+    {{UINT64_C(0x47f73039df053b01), UINT64_C(0xe47dd0326bbb054a)}},
+    {{UINT64_C(0x3d9e0e8be6efcd4d), UINT64_C(0x100d7e869b9942df)}},
+    {{UINT64_C(0xd0f0d96a09de7a7a), UINT64_C(0xc23ce412279e7a16)}},
+    {{UINT64_C(0x233a0740647e3dc2), UINT64_C(0x3e4b6c645e6dd1bb)}},
+    {{UINT64_C(0x86712a5eac94ecd7), UINT64_C(0x4874162145a3ebeb)}},
+    {{UINT64_C(0x5649310423d01a2f), UINT64_C(0x9dcea266164e1e7f)}},
+    {{UINT64_C(0x924a42f1ca94a829), UINT64_C(0x9351d90d02f4173a)}},
+    {{UINT64_C(0x5cf15314cf604fde), UINT64_C(0x67f1ef79790551b9)}},
+    {{UINT64_C(0xbe780f851000bf78), UINT64_C(0xa0efe41b27a0b430)}},
+    {{UINT64_C(0xe7925b3690478ed7), UINT64_C(0x30363f8e33dc3f3e)}},
+    {{UINT64_C(0xa67fd772dab7c848), UINT64_C(0x5b1a2db9ad783be9)}},
+    {{UINT64_C(0xb66672bd9893528b), UINT64_C(0x39263c651fe9f42b)}},
+    {{UINT64_C(0x3a6ab28d1e1e4123), UINT64_C(0xc3b9d1e5077bd697)}},
+    {{UINT64_C(0x41b1000d7a753206), UINT64_C(0x61d290a393cdc6d5)}},
+    {{UINT64_C(0x2121b4e0544ed248), UINT64_C(0xbdf44687feffc676)}},
+    {{UINT64_C(0x0e750eb5607d23e0), UINT64_C(0xeb1da1f0fa028db2)}},
+    {{UINT64_C(0x718f78a70fb79a3c), UINT64_C(0xf931d9a40fbdedf0)}},
+    {{UINT64_C(0x25b46e67899c43a3), UINT64_C(0xd7af5b3a74c7c44f)}},
+    {{UINT64_C(0x5749e600f1e2a762), UINT64_C(0xa4d65a7e2e0f3084)}},
+    {{UINT64_C(0xe265a60c8f3df818), UINT64_C(0xdebe82405ba9089a)}},
+    {{UINT64_C(0x63cc44b343165bdd), UINT64_C(0xefd89d2813af44f0)}},
+    {{UINT64_C(0xfe084774475efe4f), UINT64_C(0xae720d0ed5f3c401)}},
+    {{UINT64_C(0x4f57d428eab2190a), UINT64_C(0xd7537d222905d4e5)}},
+    {{UINT64_C(0xc2dbba29f6d349d1), UINT64_C(0xe0396bccb63b66ff)}},
+    {{UINT64_C(0x1f61960baf066419), UINT64_C(0xb32767b15ee1c3d9)}},
+    {{UINT64_C(0xe787570d03226b86), UINT64_C(0xd023dd37057f9b18)}},
+    {{UINT64_C(0xb6870445a0a9397e), UINT64_C(0xe04abfc30a5b05d7)}},
+    {{UINT64_C(0x474274399f02b91d), UINT64_C(0xad865733c571972f)}},
+    {{UINT64_C(0x907070586bd35fa1), UINT64_C(0x5a07345f0555f236)}},
+    {{UINT64_C(0xabfd79d7ce5e7191), UINT64_C(0x8e6571c473b88df5)}},
+    {{UINT64_C(0xc5394a18ee671397), UINT64_C(0xf1dee0ddef67fc84)}},
+    {{UINT64_C(0xeb072b44d641786c), UINT64_C(0x2ca87ee6972d29a2)}},
+    {{UINT64_C(0x89c54ad5f8321ac7), UINT64_C(0xc954a3afc75c5f5d)}},
+    {{UINT64_C(0x49446975d0e1fbaf), UINT64_C(0x82cf6903cdac3dd9)}},
+    {{UINT64_C(0x794a86064eda6459), UINT64_C(0x777ae2e4a7e21235)}},
+    {{UINT64_C(0xed0c1ec163b9a7df), UINT64_C(0xf1194768c8cd2d9e)}},
+    {{UINT64_C(0x00c239790beffe48), UINT64_C(0x82181ce552c1d39a)}},
+    {{UINT64_C(0xb287aada07f696c7), UINT64_C(0x269b2269172d6913)}},
+    {{UINT64_C(0x4f7fddfedf794e8f), UINT64_C(0x464c12015b8c813e)}},
+    {{UINT64_C(0xc4aa2f04e0c10c7f), UINT64_C(0x1ec19d412341809e)}},
+    {{UINT64_C(0x0c9473511287eb33), UINT64_C(0x90bc930482dd5cb5)}},
+    {{UINT64_C(0x1a280f73e2e625a4), UINT64_C(0x14600080fa8d606f)}},
+    {{UINT64_C(0x62a24e6b8914b22a), UINT64_C(0xadf2a5d731362084)}},
+    {{UINT64_C(0x0e21e9436da79596), UINT64_C(0x17ea866be5564657)}},
+    {{UINT64_C(0xaa2a4251c06f174d), UINT64_C(0x9ccacbeffb30f660)}},
+    {{UINT64_C(0x577831ca9755d8e7), UINT64_C(0x41da0cb09ca7a58a)}},
+    {{UINT64_C(0x6ef000d24fbea327), UINT64_C(0x0fa656071827fb3d)}},
+    {{UINT64_C(0x68b2192ee53e7f8e), UINT64_C(0x2091f0324aac5683)}},
+    {{UINT64_C(0xee59b01b82d5a4d3), UINT64_C(0x8c2be21597768b3f)}},
+    {{UINT64_C(0x93483589d50c37cd), UINT64_C(0x95274424e41f59d1)}},
+    {{UINT64_C(0x8c4fe4b8d73252fc), UINT64_C(0x90fc770b4eefa435)}},
+    {{UINT64_C(0x6d59cd01c5693f65), UINT64_C(0x99a224707296aa0e)}},
+    {{UINT64_C(0xe9df971a6fb4197e), UINT64_C(0xac12a71717c1282c)}},
+    {{UINT64_C(0x1fbd9d543a76d8c3), UINT64_C(0xc054f671e04aaf21)}},
+    {{UINT64_C(0xd820ab00c2c683cd), UINT64_C(0x7cffae1656317e56)}},
+    {{UINT64_C(0x47e63357e69180fa), UINT64_C(0x54d7d210f4a26eee)}},
+    {{UINT64_C(0x7599209810ba15a2), UINT64_C(0xeb47fdf54225102c)}},
+    {{UINT64_C(0x2f73d2f60d017980), UINT64_C(0xe372fbdd5322ad76)}},
+    {{UINT64_C(0xf82ea5a29e915ac3), UINT64_C(0x1f063301efc95d57)}},
+    {{UINT64_C(0x1709665277bdf385), UINT64_C(0xe7ee61b6c50c6ca5)}},
+    {{UINT64_C(0x697a573cbb3ebd0b), UINT64_C(0x788f905232052768)}},
+    {{UINT64_C(0xf4d9e483dccbbfe9), UINT64_C(0x21cd549fa5b752f8)}},
+    {{UINT64_C(0xe2e00ad71ef313ec), UINT64_C(0x21c47152a0bc381b)}},
+    {{UINT64_C(0xdfcebae91e585bd3), UINT64_C(0x7ee71c8245eeef79)}},
+    {{UINT64_C(0x706a13814f92bd11), UINT64_C(0x776ec9534e1aff16)}},
+    {{UINT64_C(0xff4a2f6052e2e36b), UINT64_C(0x88c0429541c81fc6)}},
+    {{UINT64_C(0x18ee2ae5fb899e54), UINT64_C(0xf3623ff8969718a7)}},
+    {{UINT64_C(0xd1b929c9df1282b3), UINT64_C(0xebade34b84b32b8c)}},
+    {{UINT64_C(0x01e41b6e6a6451be), UINT64_C(0x2300be81f4b80c83)}},
+    {{UINT64_C(0x22e2d714a96d33df), UINT64_C(0x030a9790f81524fe)}},
+    {{UINT64_C(0x96d84b956f6e88aa), UINT64_C(0x67b8aa6f93897338)}},
+    {{UINT64_C(0xe29e2504e22b7a2b), UINT64_C(0x6d713b0b55e2c65c)}},
+    {{UINT64_C(0x3eb620d76d508c37), UINT64_C(0x80a0b5dfa044b89f)}},
+    {{UINT64_C(0xb7cb928c725e6279), UINT64_C(0x2b40d68e77d873bc)}},
+    {{UINT64_C(0x4f3becd2979a2bff), UINT64_C(0x123d786f36e2d235)}},
+    {{UINT64_C(0xd8d8fe17a015b86c), UINT64_C(0x675b29672d5c4a64)}},
+    {{UINT64_C(0xb06aa48bd313a000), UINT64_C(0x78675dc2ec3ebabc)}},
+    {{UINT64_C(0xde746eb450048d0f), UINT64_C(0x85a8e9827e8de726)}},
+    {{UINT64_C(0xc8e91d4c0f67fcad), UINT64_C(0xe7615d96a01ee42e)}},
+    {{UINT64_C(0xc8ad6a5c6d946340), UINT64_C(0x5b6b7141651e0d8f)}},
+    {{UINT64_C(0xa5a2f9c15416be0e), UINT64_C(0x5b7a8c35fb2467d4)}},
+    {{UINT64_C(0x13168e20a517f009), UINT64_C(0x23d90f6e3d25b412)}},
+    {{UINT64_C(0x2fff4da0e6f14d9f), UINT64_C(0x2500ad513d41a040)}},
+    {{UINT64_C(0xb31173a8e0bd54b0), UINT64_C(0xc313b30d227d7ed2)}},
+    {{UINT64_C(0x9c26761f7f647ea1), UINT64_C(0x10545ee7d7e82bee)}},
+    {{UINT64_C(0x0e7863aead97f760), UINT64_C(0x7b2815b662d33831)}},
+    {{UINT64_C(0x679ab36bd43e7496), UINT64_C(0x2aae7cc43faed025)}},
+    {{UINT64_C(0xe6ad1193f9472193), UINT64_C(0xe87e3cf3178748cc)}},
+    {{UINT64_C(0x99aae64df4a31a43), UINT64_C(0x76f4604d647ef0a9)}},
+    {{UINT64_C(0xfca549e36ea3ed90), UINT64_C(0x7d31812bbd7a26d5)}},
+    {{UINT64_C(0xc8079cae5b421b58), UINT64_C(0x829490d8fc580466)}},
+    {{UINT64_C(0x85d61098ab060573), UINT64_C(0x29aa84cd825cd783)}},
+    {{UINT64_C(0x106e3d39664b14a0), UINT64_C(0x539628778ac8bb62)}},
+    {{UINT64_C(0x1fcf11e1f7094796), UINT64_C(0x8947ffa882cd4ba0)}},
+    {{UINT64_C(0x214d71f4e0b4c34c), UINT64_C(0xad295726edef5f6d)}},
+    {{UINT64_C(0xd28c606fcdf2ccd3), UINT64_C(0x0cc099424d546576)}},
+    {{UINT64_C(0xfb4c8115cbd89a6c), UINT64_C(0x1c4c893a5a73ad2d)}},
+    {{UINT64_C(0x2f67287f47b24ca1), UINT64_C(0x893162741fc731a1)}},
+    {{UINT64_C(0x8f8c53363f17a121), UINT64_C(0x2329205d93377c01)}},
+    {{UINT64_C(0xea530adedfa95ea8), UINT64_C(0x311353bec8617328)}},
+    {{UINT64_C(0xa53793787b979b5d), UINT64_C(0xbd28493d159dad22)}},
+    {{UINT64_C(0x39af876e508d34a3), UINT64_C(0x464a6ee1e9d0a413)}},
+    {{UINT64_C(0x6ce6e77102c32925), UINT64_C(0xd9d2fc28ceb21f80)}},
+    {{UINT64_C(0x1610da6ceaec2568), UINT64_C(0x09549aa20ce621ce)}},
+    {{UINT64_C(0x526864db4c9f016c), UINT64_C(0xdb7c6f628a4ec9f5)}},
+    {{UINT64_C(0x851fb667226fb6f2), UINT64_C(0x5c1a0f812e185aee)}},
+    {{UINT64_C(0x48dc7c382526b775), UINT64_C(0x9e259720d2bf1942)}},
+    {{UINT64_C(0x0b7e5155394d0121), UINT64_C(0x8df58ab87146c583)}},
+    {{UINT64_C(0x9de5afc922639f48), UINT64_C(0x139fb6b6f09bb0df)}},
+    {{UINT64_C(0xe90436242d5b7f9e), UINT64_C(0x0366a0242ad46493)}},
+    {{UINT64_C(0x4449ee7a40e9254f), UINT64_C(0xf2c42ef17d2eccb8)}},
+    {{UINT64_C(0x3da2bbfe74cf0b7e), UINT64_C(0xcdb15be1c997ce55)}},
+    {{UINT64_C(0x241fcfed1b780634), UINT64_C(0x435113014360e8ba)}}
+};
+
+/**
+ * dest = table<sup>power</sup> % characteristic_polynomial,
+ * where table[i] = x<sup>2<sup>i</sup></sup>. For jump_table x is t,
+ * and for back_jump_table x is t<sup>-1</sup>.
+ * Only one multiplication is needed for each set bit of power.
+ * @param dest the result of calculation
+ * @param table table of x<sup>2<sup>i</sup></sup>
+ * @param power_hi upper 64 bits of exponential part
+ * @param power_lo lower 64 bits of exponential part
+ */
+static void power_by_table(f2_poly128 * dest, const f2_poly128 table[],
+			   uint64_t power_hi, uint64_t power_lo)
+{
+    f2_poly128 result;
+    uint64_t power[2];
+    int first = 1;
+    result.ar[0] = 1;
+    result.ar[1] = 0;
+    power[0] = power_lo;
+    power[1] = power_hi;
+    for (int i = 0; i < 2; i++) {
+	uint64_t tmp_power = power[i];
+	for (int j = 0; tmp_power != 0; j++) {
+	    if ((tmp_power & 1) != 0) {
+		if (first) {
+		    result = table[i * 64 + j];
+		    first = 0;
+		} else {
+		    mul_mod_phi(&result, &table[i * 64 + j]);
+		}
+	    }
+	    tmp_power = tmp_power >> 1;
+	}
+    }
+    *dest = result;
+}
+
+/**
+ * dest = t<sup>power</sup> % characteristic_polynomial
+ * @param dest the result of calculation
+ * @param power_hi upper 64 bits of exponential part
+ * @param power_lo lower 64 bits of exponential part
+ */
+static void power_mod_phi_u128(f2_poly128 * dest,
+			       uint64_t power_hi, uint64_t power_lo)
+{
+    power_by_table(dest, jump_table, power_hi, power_lo);
+}
+
+/**
+ * dest = t<sup>-power</sup> % characteristic_polynomial
+ * @param dest the result of calculation
+ * @param power_hi upper 64 bits of exponential part
+ * @param power_lo lower 64 bits of exponential part
+ */
+static void power_back_mod_phi_u128(f2_poly128 * dest,
+				    uint64_t power_hi, uint64_t power_lo)
+{
+    power_by_table(dest, back_jump_table, power_hi, power_lo);
+}
+
+/**
+ * dest = t<sup>power</sup> % characteristic_polynomial
+ * @param dest the result of calculation
+ * @param power exponential part
+ */
+static void power_mod_phi(f2_poly128 * dest, const uz * power)
+{
+    uint64_t power_hi = 0;
+    uint64_t power_lo = 0;
+    for (int i = 0; i < 4; i++) {
+	power_lo |= (uint64_t)power->ar[i] << (16 * i);
+	power_hi |= (uint64_t)power->ar[i + 4] << (16 * i);
+    }
+    power_by_table(dest, jump_table, power_hi, power_lo);
 }
 
 /**
@@ -33,6 +33,7 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+#include <stddef.h>
 #include <stdint.h>
 #include <inttypes.h>
 
@@ -88,6 +89,27 @@ extern "C" {
         xsadd->state[3] = t;
     }
 
+    /**
+     * This function changes internal state of xsadd back by one step,
+     * the inverse of xsadd_next_state().
+     * Users should not call this function directly.
+     * @param[in,out] xsadd xsadd internal state
+     */
+    static inline void xsadd_prev_state(xsadd_t * xsadd)
+    {
+        static const int sh1 = 15;
+        static const int sh2 = 18;
+        static const int sh3 = 11;
+        uint32_t t;
+        t = xsadd->state[3] ^ (xsadd->state[2] << sh3);
+        t ^= t >> sh2;
+        t ^= (t << sh1) ^ (t << (2 * sh1));
+        xsadd->state[3] = xsadd->state[2];
+        xsadd->state[2] = xsadd->state[1];
+        xsadd->state[1] = xsadd->state[0];
+        xsadd->state[0] = t;
+    }
+
     /**
      * This function outputs 32-bit unsigned integer from internal state.
      * @param[in,out] xsadd xsadd internal state
@@ -99,6 +121,21 @@ extern "C" {
         return xsadd->state[3] + xsadd->state[2];
     }
 
+    /**
+     * This function outputs 32-bit unsigned integer backward.
+     * It returns the last output of xsadd_uint32() and changes the
+     * internal state back by one step, so that xsadd_uint32_prev()
+     * returns the outputs of xsadd_uint32() in reverse order.
+     * @param[in,out] xsadd xsadd internal state
+     * @return 32-bit unsigned integer r (0 <= r < 2^32)
+     */
+    static inline uint32_t xsadd_uint32_prev(xsadd_t * xsadd)
+    {
+        uint32_t r = xsadd->state[3] + xsadd->state[2];
+        xsadd_prev_state(xsadd);
+        return r;
+    }
+
     /**
      * This function outputs floating point number from internal state.
      * This function is implemented using multiplying by 1 / 2^23.
@@ -136,6 +173,118 @@ extern "C" {
 	return a * XSADD_DOUBLE_MUL;
     }
 
+    /**
+     * This function outputs double precision floating point number from
+     * internal state.
+     * @param[in,out] xsadd xsadd internal state
+     * @return floating point number r (0.0 < r <= 1.0)
+     */
+    inline static double xsadd_doubleOC(xsadd_t * xsadd)
+    {
+	return 1.0 - xsadd_double(xsadd);
+    }
+
+    /**
+     * This function outputs an unbiased 32-bit unsigned integer in the
+     * range [0, n), by the nearly divisionless method of D. Lemire.
+     * The high 32 bits of the 64-bit product of the output and n is
+     * the result, and the output is rejected only if the low 32 bits
+     * are less than 2<sup>32</sup> % n. The division is done only when
+     * the low 32 bits are less than n, which is rare for small n.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[in] n upper bound, n > 0
+     * @return 32-bit unsigned integer r (0 <= r < n)
+     */
+    static inline uint32_t xsadd_uint32_bounded(xsadd_t * xsadd, uint32_t n)
+    {
+        uint64_t m = (uint64_t)xsadd_uint32(xsadd) * n;
+        uint32_t low = (uint32_t)m;
+        if (low < n) {
+            uint32_t t = (0 - n) % n;
+            while (low < t) {
+                m = (uint64_t)xsadd_uint32(xsadd) * n;
+                low = (uint32_t)m;
+            }
+        }
+        return (uint32_t)(m >> 32);
+    }
+
+    /**
+     * This function fills an array with 32-bit unsigned integers.
+     * The array is filled with the same sequence as calling
+     * xsadd_uint32() \b size times. Large arrays (512 KiB or more)
+     * are split into eight parts, which are generated at once by the
+     * vector kernel from states jumped to the start of each part.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_uint32(xsadd_t * xsadd, uint32_t array[],
+				 size_t size);
+
+    /**
+     * This function fills an array with unbiased 32-bit unsigned
+     * integers in the range [0, n). The array is filled with the same
+     * sequence as calling xsadd_uint32_bounded() \b size times.
+     * The outputs are generated by xsadd_fill_array_uint32() and
+     * multiplied by n with the vector kernel, and rejected outputs are
+     * removed out of the vector loop.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     * @param[in] n upper bound, n > 0
+     */
+    void xsadd_fill_bounded(xsadd_t * xsadd, uint32_t array[], size_t size,
+			    uint32_t n);
+
+    /**
+     * This function fills an array with floating point numbers in the
+     * range [0, 1). The array is filled with the same sequence as
+     * calling xsadd_float() \b size times. Large arrays are generated
+     * like xsadd_fill_array_uint32() by small chunks, which are
+     * converted by the vector kernel while they are in cache.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_float(xsadd_t * xsadd, float array[],
+				size_t size);
+
+    /**
+     * This function fills an array with floating point numbers in the
+     * range (0, 1]. The array is filled with the same sequence as
+     * calling xsadd_floatOC() \b size times.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_floatOC(xsadd_t * xsadd, float array[],
+				  size_t size);
+
+    /**
+     * This function fills an array with double precision floating
+     * point numbers in the range [0, 1). The array is filled with the
+     * same sequence as calling xsadd_double() \b size times.
+     * Conversion is done by the vector kernel as
+     * xsadd_fill_array_float().
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_double(xsadd_t * xsadd, double array[],
+				 size_t size);
+
+    /**
+     * This function fills an array with double precision floating
+     * point numbers in the range (0, 1]. The array is filled with the
+     * same sequence as calling xsadd_doubleOC() \b size times.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_doubleOC(xsadd_t * xsadd, double array[],
+				   size_t size);
+
     /* =============
      * JUMP function
      * ============= */
@@ -178,6 +327,427 @@ extern "C" {
 					 uint32_t mul_step,
 					 const char * base_step);
 
+    /**
+     * jump polynomial in binary form.
+     * This is 16 bytes and can be copied and stored freely, but the
+     * members should not be accessed directly.
+     */
+    typedef struct {
+        uint64_t poly[2];
+    } xsadd_jump_poly_t;
+
+    /**
+     * This function calculates jump polynomial in binary form.
+     * The result is the same as xsadd_calculate_jump_polynomial(), but
+     * it is not converted to string.
+     * @param[out] jump_poly the result of this calculation.
+     * @param[in] mul_step jump step is mul_step * base_step.
+     * @param[in] base_step hexadecimal string of jump base.
+     */
+    void xsadd_calculate_jump_poly(xsadd_jump_poly_t * jump_poly,
+				   uint32_t mul_step,
+				   const char * base_step);
+
+    /**
+     * This function jumps using the jump polynomial in binary form.
+     * No string conversion is done, so this function is the fastest
+     * way to jump the same distance many times.
+     * @param[in,out] xsadd xsadd structure, overwritten by new state
+     * after calling this function.
+     * @param[in] jump_poly the jump polynomial calculated by
+     * xsadd_calculate_jump_poly.
+     */
+    void xsadd_jump_by_poly(xsadd_t * xsadd,
+			    const xsadd_jump_poly_t * jump_poly);
+
+    /**
+     * This function calculates jump polynomial in binary form for an
+     * arbitrary 128-bit step, step_hi * 2<sup>64</sup> + step_lo.
+     * @param[out] jump_poly the result of this calculation.
+     * @param[in] step_hi upper 64 bits of jump step.
+     * @param[in] step_lo lower 64 bits of jump step.
+     */
+    void xsadd_calculate_jump_poly_u128(xsadd_jump_poly_t * jump_poly,
+					uint64_t step_hi, uint64_t step_lo);
+
+    /**
+     * This function jumps the internal state by an arbitrary 128-bit
+     * step, step_hi * 2<sup>64</sup> + step_lo.
+     * @param[in,out] xsadd xsadd structure, overwritten by new state
+     * after calling this function.
+     * @param[in] step_hi upper 64 bits of jump step.
+     * @param[in] step_lo lower 64 bits of jump step.
+     */
+    void xsadd_jump_u128(xsadd_t * xsadd, uint64_t step_hi, uint64_t step_lo);
+
+    /**
+     * This function advances the internal state by \b n steps, that
+     * is, the same as calling xsadd_uint32() \b n times and discarding
+     * the outputs. Short distances are stepped one by one, and long
+     * distances are jumped.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[in] n number of steps
+     */
+    void xsadd_discard(xsadd_t * xsadd, uint64_t n);
+
+    /**
+     * This function calculates jump polynomial in binary form for a
+     * backward jump of step_hi * 2<sup>64</sup> + step_lo steps.
+     * The table of t<sup>-2<sup>i</sup></sup> is used, so this is as
+     * fast as xsadd_calculate_jump_poly_u128().
+     * @param[out] jump_poly the result of this calculation.
+     * @param[in] step_hi upper 64 bits of jump step.
+     * @param[in] step_lo lower 64 bits of jump step.
+     */
+    void xsadd_calculate_jump_back_poly_u128(xsadd_jump_poly_t * jump_poly,
+					     uint64_t step_hi,
+					     uint64_t step_lo);
+
+    /**
+     * This function jumps the internal state backward by
+     * step_hi * 2<sup>64</sup> + step_lo steps.
+     * @param[in,out] xsadd xsadd structure, overwritten by new state
+     * after calling this function.
+     * @param[in] step_hi upper 64 bits of jump step.
+     * @param[in] step_lo lower 64 bits of jump step.
+     */
+    void xsadd_jump_back_u128(xsadd_t * xsadd,
+			      uint64_t step_hi, uint64_t step_lo);
+
+    /**
+     * This function changes the internal state back by \b n steps,
+     * the inverse of xsadd_discard(). Short distances are stepped
+     * back one by one, and long distances are jumped.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[in] n number of steps
+     */
+    void xsadd_rewind(xsadd_t * xsadd, uint64_t n);
+
+    /**
+     * This function fills an array with 32-bit unsigned integers
+     * backward, the same as calling xsadd_uint32_prev() \b size times.
+     * array[0] is the last output of xsadd_uint32().
+     * Large arrays are generated forward by xsadd_fill_array_uint32()
+     * from the state jumped back by \b size, and reversed.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_uint32_reverse(xsadd_t * xsadd, uint32_t array[],
+					 size_t size);
+
+    /**
+     * This function converts jump polynomial from hexadecimal string
+     * to binary form. Polynomials of degree 128 or more are reduced
+     * modulo the characteristic polynomial, which does not change the
+     * jump.
+     * @param[out] jump_poly jump polynomial in binary form.
+     * @param[in] jump_str jump polynomial in hexadecimal string.
+     */
+    void xsadd_jump_poly_from_str(xsadd_jump_poly_t * jump_poly,
+				  const char * jump_str);
+
+    /**
+     * This function converts jump polynomial from binary form to
+     * hexadecimal string, in the format of
+     * xsadd_calculate_jump_polynomial().
+     * jump_str needs 33 bytes memory.
+     * @param[out] jump_str jump polynomial in hexadecimal string.
+     * @param[in] jump_poly jump polynomial in binary form.
+     */
+    void xsadd_jump_poly_to_str(char * jump_str,
+				const xsadd_jump_poly_t * jump_poly);
+
+    /**
+     * This function calculates the jump polynomial of the composite
+     * jump, that is, jumping by \b dest is the same as jumping by
+     * \b x and then by \b y. The steps are added.
+     * @param[out] dest the result of this calculation.
+     * @param[in] x jump polynomial.
+     * @param[in] y jump polynomial.
+     */
+    void xsadd_jump_poly_mul(xsadd_jump_poly_t * dest,
+			     const xsadd_jump_poly_t * x,
+			     const xsadd_jump_poly_t * y);
+
+    /**
+     * This function calculates the jump polynomial of jumping by \b x
+     * \b e times. The step is multiplied by \b e.
+     * @param[out] dest the result of this calculation.
+     * @param[in] x jump polynomial.
+     * @param[in] e exponent.
+     */
+    void xsadd_jump_poly_pow(xsadd_jump_poly_t * dest,
+			     const xsadd_jump_poly_t * x,
+			     uint64_t e);
+
+    /**
+     * This function makes \b n streams which do not overlap each
+     * other. out[0] is a copy of \b root, and out[i + 1] is out[i]
+     * jumped by step_hi * 2<sup>64</sup> + step_lo. The jump polynomial
+     * is calculated only once.
+     * xsadd_spawn_streams_parallel() in xsadd_parallel.h splits the
+     * work across threads.
+     * @param[in] root xsadd state of the first stream.
+     * @param[out] out array of \b n xsadd states.
+     * @param[in] n number of streams.
+     * @param[in] step_hi upper 64 bits of jump step.
+     * @param[in] step_lo lower 64 bits of jump step.
+     */
+    void xsadd_spawn_streams(const xsadd_t * root, xsadd_t out[], size_t n,
+			     uint64_t step_hi, uint64_t step_lo);
+
+    /**
+     * This function is the same as xsadd_spawn_streams(), except that
+     * the step is given by jump polynomial.
+     * @param[in] root xsadd state of the first stream.
+     * @param[out] out array of \b n xsadd states.
+     * @param[in] n number of streams.
+     * @param[in] jump_poly jump polynomial of the step.
+     */
+    void xsadd_spawn_streams_by_poly(const xsadd_t * root, xsadd_t out[],
+				     size_t n,
+				     const xsadd_jump_poly_t * jump_poly);
+
+    /* ==========================
+     * position tracking stream
+     * ========================== */
+    /**
+     * xsadd internal state with its position, the number of outputs
+     * from the origin. The origin is kept, so that the stream can seek
+     * to any position.
+     * Use only xsadd_pos_* functions to generate from xsadd_pos_t,
+     * otherwise the position is not updated.
+     */
+    typedef struct {
+        xsadd_t xsadd;
+        xsadd_t origin;
+        uint64_t pos_hi;
+        uint64_t pos_lo;
+    } xsadd_pos_t;
+
+    /**
+     * This function initializes xsadd_pos_t with a 32-bit unsigned
+     * integer seed. The position 0 is the state just after
+     * xsadd_init().
+     * @param[out] xsadd_pos position tracking stream.
+     * @param[in] seed a 32-bit unsigned integer used as a seed.
+     */
+    void xsadd_pos_init(xsadd_pos_t * xsadd_pos, uint32_t seed);
+
+    /**
+     * This function initializes xsadd_pos_t, the position 0 is
+     * \b xsadd.
+     * @param[out] xsadd_pos position tracking stream.
+     * @param[in] xsadd xsadd state of the position 0.
+     */
+    void xsadd_pos_init_by_xsadd(xsadd_pos_t * xsadd_pos,
+				 const xsadd_t * xsadd);
+
+    /**
+     * This function outputs 32-bit unsigned integer and advances the
+     * position by one.
+     * @param[in,out] xsadd_pos position tracking stream.
+     * @return 32-bit unsigned integer r (0 <= r < 2^32)
+     */
+    static inline uint32_t xsadd_pos_uint32(xsadd_pos_t * xsadd_pos)
+    {
+        xsadd_pos->pos_lo++;
+        if (xsadd_pos->pos_lo == 0) {
+            xsadd_pos->pos_hi++;
+        }
+        return xsadd_uint32(&xsadd_pos->xsadd);
+    }
+
+    /**
+     * This function fills an array with 32-bit unsigned integers and
+     * advances the position by \b size.
+     * @param[in,out] xsadd_pos position tracking stream.
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_pos_fill_array_uint32(xsadd_pos_t * xsadd_pos,
+				     uint32_t array[], size_t size);
+
+    /**
+     * This function returns the current position.
+     * @param[in] xsadd_pos position tracking stream.
+     * @param[out] pos_hi upper 64 bits of the position.
+     * @param[out] pos_lo lower 64 bits of the position.
+     */
+    void xsadd_tell(const xsadd_pos_t * xsadd_pos,
+		    uint64_t * pos_hi, uint64_t * pos_lo);
+
+    /**
+     * This function moves the stream to the absolute position
+     * pos_hi * 2<sup>64</sup> + pos_lo, that is, the next output is
+     * the same as the output of the stream at that position.
+     * The stream jumps forward or backward from the current state, or
+     * forward from the origin if it is nearer. The jump is the product
+     * of the precomputed t<sup>2<sup>i</sup></sup> or
+     * t<sup>-2<sup>i</sup></sup> for the set bits of the distance, so
+     * the time is O(log distance). Short seeks step one by one like
+     * xsadd_discard() and xsadd_rewind().
+     * @param[in,out] xsadd_pos position tracking stream.
+     * @param[in] pos_hi upper 64 bits of the position.
+     * @param[in] pos_lo lower 64 bits of the position.
+     */
+    void xsadd_seek(xsadd_pos_t * xsadd_pos,
+		    uint64_t pos_hi, uint64_t pos_lo);
+
+    /**
+     * This function returns the output of the stream \b xsadd at
+     * position \b index, that is, the (index + 1)-th output of
+     * xsadd_uint32() from \b xsadd, without changing \b xsadd.
+     * A copy of the state is advanced by xsadd_discard(), so the time
+     * is O(log index) for large index.
+     * @param[in] xsadd xsadd state of the position 0.
+     * @param[in] index position of the output.
+     * @return 32-bit unsigned integer r (0 <= r < 2^32)
+     */
+    uint32_t xsadd_at(const xsadd_t * xsadd, uint64_t index);
+
+    /**
+     * This function is the same as calling xsadd_at() for each
+     * element of \b index, but it moves one copy of the state from
+     * index[i - 1] to index[i], so the time depends on the gaps
+     * between neighbouring indices instead of their distance from the
+     * origin. Small gaps are stepped one by one and large gaps are
+     * jumped, like xsadd_discard(). \b index should be sorted in
+     * ascending order. Unsorted indices give the same result, but are
+     * slower.
+     * @param[in] xsadd xsadd state of the position 0.
+     * @param[out] out array of \b size outputs.
+     * @param[in] index array of \b size positions.
+     * @param[in] size number of elements of the arrays.
+     */
+    void xsadd_at_many(const xsadd_t * xsadd, uint32_t out[],
+		       const uint64_t index[], size_t size);
+
+    /* ==========================
+     * 8-lane multi-stream version
+     * ========================== */
+    /**
+     * number of streams in xsadd8_t
+     */
+#define XSADD8_LANES 8
+
+    /**
+     * eight xsadd internal state vectors in structure of arrays form.
+     * state[i][lane] is the state[i] of the stream \b lane, so that
+     * state[i] can be loaded into one 256-bit register.
+     */
+    typedef struct {
+        uint32_t state[4][XSADD8_LANES];
+    } xsadd8_t;
+
+    /**
+     * This function initializes eight streams with a 32-bit unsigned
+     * integer seed. The stream 0 is initialized by xsadd_init(), and
+     * the stream i + 1 is the stream i jumped by xsadd_jump_base_step,
+     * so that the streams do not overlap.
+     * @param[out] xsadd8 xsadd8 state vectors.
+     * @param[in] seed a 32-bit unsigned integer used as a seed.
+     */
+    void xsadd8_init(xsadd8_t * xsadd8, uint32_t seed);
+
+    /**
+     * This function initializes eight streams from an xsadd state.
+     * The stream 0 is a copy of \b xsadd, and the stream i + 1 is the
+     * stream i jumped by xsadd_jump_base_step.
+     * @param[out] xsadd8 xsadd8 state vectors.
+     * @param[in] xsadd xsadd state vector of the stream 0.
+     */
+    void xsadd8_init_by_xsadd(xsadd8_t * xsadd8, const xsadd_t * xsadd);
+
+    /**
+     * This function copies out one stream of xsadd8.
+     * @param[out] xsadd xsadd state vector.
+     * @param[in] xsadd8 xsadd8 state vectors.
+     * @param[in] lane stream number, 0 <= lane < XSADD8_LANES.
+     */
+    static inline void xsadd8_get_lane(xsadd_t * xsadd,
+				       const xsadd8_t * xsadd8, int lane)
+    {
+        for (int i = 0; i < 4; i++) {
+            xsadd->state[i] = xsadd8->state[i][lane];
+        }
+    }
+
+    /**
+     * This function changes internal state of all streams of xsadd8.
+     * Users should not call this function directly.
+     * @param[in,out] xsadd8 xsadd8 internal state
+     */
+    static inline void xsadd8_next_state(xsadd8_t * xsadd8)
+    {
+        static const int sh1 = 15;
+        static const int sh2 = 18;
+        static const int sh3 = 11;
+        for (int j = 0; j < XSADD8_LANES; j++) {
+            uint32_t t;
+            t = xsadd8->state[0][j];
+            t ^= t << sh1;
+            t ^= t >> sh2;
+            t ^= xsadd8->state[3][j] << sh3;
+            xsadd8->state[0][j] = xsadd8->state[1][j];
+            xsadd8->state[1][j] = xsadd8->state[2][j];
+            xsadd8->state[2][j] = xsadd8->state[3][j];
+            xsadd8->state[3][j] = t;
+        }
+    }
+
+    /**
+     * This function outputs one 32-bit unsigned integer from each
+     * stream.
+     * @param[in,out] xsadd8 xsadd8 internal state
+     * @param[out] array array[lane] is the output of the stream
+     * \b lane.
+     */
+    static inline void xsadd8_uint32(xsadd8_t * xsadd8,
+				     uint32_t array[XSADD8_LANES])
+    {
+        xsadd8_next_state(xsadd8);
+        for (int j = 0; j < XSADD8_LANES; j++) {
+            array[j] = xsadd8->state[3][j] + xsadd8->state[2][j];
+        }
+    }
+
+    /**
+     * This function fills an array with 32-bit unsigned integers of
+     * eight streams. array[XSADD8_LANES * k + lane] is the k-th output
+     * of the stream \b lane. The result is the same as calling
+     * xsadd8_uint32() \b size / XSADD8_LANES times.
+     * @param[in,out] xsadd8 xsadd8 internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array, which must be
+     * a multiple of XSADD8_LANES.
+     */
+    void xsadd8_fill_array_uint32(xsadd8_t * xsadd8, uint32_t array[],
+				  size_t size);
+
+    /* ====================
+     * bulk generation kernel
+     * ==================== */
+    /**
+     * This function returns the name of the kernel used by bulk
+     * generation functions, one of "avx512", "avx2", "sse2" and
+     * "generic". The kernel is selected at the first use: the kernel
+     * named by environment variable XSADD_KERNEL if the CPU supports
+     * it, otherwise the widest kernel the CPU supports. The output
+     * does not depend on the kernel.
+     * @return kernel name
+     */
+    const char * xsadd_kernel_name(void);
+
+    /**
+     * This function forces the kernel used by bulk generation
+     * functions. This is intended for benchmarks and tests.
+     * @param[in] name kernel name
+     * @return 0 if success, -1 if the kernel is unknown or not
+     * supported by the CPU.
+     */
+    int xsadd_set_kernel(const char * name);
 
 #ifdef __cplusplus
 }
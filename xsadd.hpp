@@ -0,0 +1,409 @@
+#ifndef XSADD_HPP
+#define XSADD_HPP
+/**
+ * @file xsadd.hpp
+ *
+ * @brief XORSHIFT-ADD: C++ random number engine.
+ *
+ * xsadd_engine and xsadd_engine64 meet the requirements of
+ * UniformRandomBitGenerator and RandomNumberEngine of C++11, so they
+ * can be used with the distributions of &lt;random&gt;.
+ * The generation is inline, and only seeding and long discard call
+ * the functions in xsadd.c.
+ *
+ * xsadd_constexpr_jump_poly() and xsadd_constexpr_jump_poly_u128()
+ * calculate jump polynomials at compile time.
+ *
+ * @author Mutsuo Saito (Manieth Corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (c) 2014
+ * Mutsuo Saito, Makoto Matsumoto, Hiroshima University
+ * and Manieth Corp.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xsadd.h"
+#include <istream>
+#include <ostream>
+#include <limits>
+#include <type_traits>
+
+/**
+ * random number engine of xsadd.
+ * UIntType is uint32_t or uint64_t. The 64-bit version returns two
+ * outputs of xsadd_uint32(), the first one in the upper bits, so that
+ * std::uniform_real_distribution&lt;double&gt; calls it only once.
+ */
+template<typename UIntType>
+class basic_xsadd_engine {
+    static_assert(std::is_same<UIntType, uint32_t>::value
+                  || std::is_same<UIntType, uint64_t>::value,
+                  "result_type must be uint32_t or uint64_t");
+public:
+    typedef UIntType result_type;
+
+    /**
+     * number of 32-bit outputs of xsadd for one result.
+     */
+    static constexpr unsigned words_per_result = sizeof(UIntType) / 4;
+    static constexpr result_type default_seed = 1234;
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    basic_xsadd_engine() {
+        seed(default_seed);
+    }
+
+    explicit basic_xsadd_engine(result_type value) {
+        seed(value);
+    }
+
+    template<typename Sseq, typename = typename std::enable_if<
+                 !std::is_convertible<Sseq, result_type>::value
+                 && !std::is_same<typename std::remove_cv<Sseq>::type,
+                                  basic_xsadd_engine>::value
+                 && !std::is_same<typename std::remove_cv<Sseq>::type,
+                                  xsadd_t>::value>::type>
+    explicit basic_xsadd_engine(Sseq& q) {
+        seed(q);
+    }
+
+    /**
+     * construct from xsadd state.
+     * @param xsadd xsadd internal state
+     */
+    explicit basic_xsadd_engine(const xsadd_t& xsadd) : xs(xsadd) {
+    }
+
+    /**
+     * seed by xsadd_init(). The 64-bit seed is folded into 32 bits.
+     * @param value seed
+     */
+    void seed(result_type value = default_seed) {
+        uint64_t v = value;
+        xsadd_init(&xs, static_cast<uint32_t>(v ^ (v >> 32)));
+    }
+
+    /**
+     * seed by xsadd_init_by_array() with four words generated by
+     * seed sequence.
+     * @param q seed sequence
+     */
+    template<typename Sseq>
+    typename std::enable_if<!std::is_convertible<Sseq, result_type>::value>
+    ::type seed(Sseq& q) {
+        uint32_t key[4];
+        q.generate(key, key + 4);
+        xsadd_init_by_array(&xs, key, 4);
+    }
+
+    result_type operator()() {
+        if (words_per_result == 2) {
+            uint64_t hi = xsadd_uint32(&xs);
+            return static_cast<result_type>((hi << 32) | xsadd_uint32(&xs));
+        }
+        return xsadd_uint32(&xs);
+    }
+
+    /**
+     * advance the state by z results. Long distances are jumped.
+     * @param z number of results
+     */
+    void discard(unsigned long long z) {
+        uint64_t n = z;
+        if (words_per_result == 2 && (n >> 63) != 0) {
+            xsadd_jump_u128(&xs, n >> 63, n << 1);
+        } else {
+            xsadd_discard(&xs, n * words_per_result);
+        }
+    }
+
+    /**
+     * @return xsadd internal state
+     */
+    const xsadd_t& state() const {
+        return xs;
+    }
+
+    friend bool operator==(const basic_xsadd_engine& x,
+                           const basic_xsadd_engine& y) {
+        for (int i = 0; i < 4; i++) {
+            if (x.xs.state[i] != y.xs.state[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const basic_xsadd_engine& x,
+                           const basic_xsadd_engine& y) {
+        return !(x == y);
+    }
+
+    /**
+     * write the state as four decimal numbers separated by space.
+     */
+    template<typename CharT, typename Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<<(std::basic_ostream<CharT, Traits>& os,
+               const basic_xsadd_engine& x) {
+        typename std::basic_ostream<CharT, Traits>::fmtflags flags
+            = os.flags();
+        CharT fill = os.fill();
+        os.flags(std::ios_base::dec | std::ios_base::left);
+        os.fill(os.widen(' '));
+        for (int i = 0; i < 4; i++) {
+            if (i > 0) {
+                os << os.widen(' ');
+            }
+            os << x.xs.state[i];
+        }
+        os.flags(flags);
+        os.fill(fill);
+        return os;
+    }
+
+    /**
+     * read the state written by operator<<. If it fails, or the state
+     * is all zero, failbit is set and x is unchanged.
+     */
+    template<typename CharT, typename Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>>(std::basic_istream<CharT, Traits>& is,
+               basic_xsadd_engine& x) {
+        typename std::basic_istream<CharT, Traits>::fmtflags flags
+            = is.flags();
+        xsadd_t tmp;
+        is.flags(std::ios_base::dec | std::ios_base::skipws);
+        for (int i = 0; i < 4; i++) {
+            is >> tmp.state[i];
+        }
+        is.flags(flags);
+        if (!is.fail()) {
+            if ((tmp.state[0] | tmp.state[1] | tmp.state[2] | tmp.state[3])
+                == 0) {
+                is.setstate(std::ios_base::failbit);
+            } else {
+                x.xs = tmp;
+            }
+        }
+        return is;
+    }
+
+private:
+    xsadd_t xs;
+};
+
+template<typename UIntType>
+constexpr unsigned basic_xsadd_engine<UIntType>::words_per_result;
+
+template<typename UIntType>
+constexpr UIntType basic_xsadd_engine<UIntType>::default_seed;
+
+/**
+ * engine returning 32-bit unsigned integers.
+ */
+typedef basic_xsadd_engine<uint32_t> xsadd_engine;
+
+/**
+ * engine returning 64-bit unsigned integers, two outputs of xsadd.
+ */
+typedef basic_xsadd_engine<uint64_t> xsadd_engine64;
+
+/*
+ * compile time calculation of jump polynomials, the constexpr version
+ * of power_mod_phi and mul_mod_phi in xsadd.c. C++11 constexpr
+ * functions can not have loops, so the loops are recursions, at most
+ * 128 deep.
+ */
+namespace xsadd_detail {
+    /**
+     * 128-bit polynomial over F<sub>2</sub>, or 128-bit integer.
+     */
+    struct word128 {
+        uint64_t lo;
+        uint64_t hi;
+    };
+
+    /**
+     * characteristic polynomial without t<sup>128</sup>.
+     */
+    constexpr uint64_t phi_lo = UINT64_C(0x0085118000000001);
+    constexpr uint64_t phi_hi = UINT64_C(0x0000000000810184);
+
+    constexpr int bit(word128 x, int i) {
+        return static_cast<int>((i >= 64 ? x.hi >> (i - 64) : x.lo >> i) & 1);
+    }
+
+    /**
+     * @return the index of the highest set bit from i down, or -1.
+     */
+    constexpr int top_bit(word128 x, int i) {
+        return i < 0 || bit(x, i) ? i : top_bit(x, i - 1);
+    }
+
+    /**
+     * x * t % phi. The mod is one fold, because the degree is at most
+     * 128.
+     */
+    constexpr word128 mul_t_mod_phi(word128 x) {
+        return word128{(x.lo << 1) ^ ((x.hi >> 63) ? phi_lo : 0),
+                       ((x.hi << 1) | (x.lo >> 63))
+                       ^ ((x.hi >> 63) ? phi_hi : 0)};
+    }
+
+    constexpr word128 add_if(word128 x, word128 y, int b) {
+        return b ? word128{x.lo ^ y.lo, x.hi ^ y.hi} : x;
+    }
+
+    /**
+     * r * t<sup>i + 1</sup> + x * (bits i, ..., 0 of y) % phi, by Horner's
+     * method.
+     */
+    constexpr word128 mul_mod_phi_from(word128 r, word128 x, word128 y,
+                                       int i) {
+        return i < 0 ? r
+            : mul_mod_phi_from(add_if(mul_t_mod_phi(r), x, bit(y, i)),
+                               x, y, i - 1);
+    }
+
+    /**
+     * x * y % phi.
+     */
+    constexpr word128 mul_mod_phi(word128 x, word128 y) {
+        return mul_mod_phi_from(word128{0, 0}, x, y, top_bit(y, 127));
+    }
+
+    /**
+     * r<sup>2<sup>i + 1</sup></sup> * t<sup>bits i, ..., 0 of e</sup>
+     * % phi, by square and multiply.
+     */
+    constexpr word128 power_t_mod_phi_from(word128 r, word128 e, int i) {
+        return i < 0 ? r
+            : power_t_mod_phi_from(bit(e, i)
+                                   ? mul_t_mod_phi(mul_mod_phi(r, r))
+                                   : mul_mod_phi(r, r), e, i - 1);
+    }
+
+    /**
+     * t<sup>e</sup> % phi.
+     */
+    constexpr word128 power_t_mod_phi(word128 e) {
+        return power_t_mod_phi_from(word128{1, 0}, e, top_bit(e, 127));
+    }
+
+    /**
+     * x * y % 2<sup>128</sup>, the same truncation as uz_mul() in
+     * xsadd.c.
+     */
+    constexpr word128 mul_u32(word128 x, uint32_t y) {
+        return word128{
+            ((x.lo & 0xffffffffU) * y)
+            + ((((x.lo >> 32) * y) & 0xffffffffU) << 32),
+            x.hi * y + (((x.lo >> 32) * y) >> 32)
+            + ((((x.lo & 0xffffffffU) * y >> 32)
+                + (((x.lo >> 32) * y) & 0xffffffffU)) >> 32)};
+    }
+
+    constexpr int hex_digit(char c) {
+        return c >= '0' && c <= '9' ? c - '0'
+            : c >= 'a' && c <= 'f' ? c - 'a' + 10
+            : c >= 'A' && c <= 'F' ? c - 'A' + 10
+            : -1;
+    }
+
+    /**
+     * v * 16<sup>n</sup> + str as 128-bit integer, where n is the
+     * number of hexadecimal digits of str up to \b rest. Like
+     * string16touz() in xsadd.c, digits after the first 32 are
+     * ignored.
+     */
+    constexpr word128 parse_hex(const char * str, word128 v, int rest) {
+        return rest == 0 || hex_digit(*str) < 0 ? v
+            : parse_hex(str + 1,
+                        word128{(v.lo << 4)
+                                | static_cast<uint64_t>(hex_digit(*str)),
+                                (v.hi << 4) | (v.lo >> 60)},
+                        rest - 1);
+    }
+
+    constexpr xsadd_jump_poly_t to_jump_poly(word128 x) {
+        return xsadd_jump_poly_t{{x.lo, x.hi}};
+    }
+}
+
+/**
+ * xsadd_jump_base_step, 3<sup>41</sup>, usable in constant expressions.
+ */
+constexpr char xsadd_constexpr_jump_base_step[] = "1FA2A1CF67B5FB863";
+
+/**
+ * This function calculates the jump polynomial of
+ * step_hi * 2<sup>64</sup> + step_lo steps, the same as
+ * xsadd_calculate_jump_poly_u128(). In a constant expression it is
+ * calculated at compile time, and only xsadd_jump_by_poly() remains
+ * at run time:
+ * <pre>
+ * static constexpr xsadd_jump_poly_t jump_2_64
+ *     = xsadd_constexpr_jump_poly_u128(1, 0);
+ * xsadd_jump_by_poly(&xsadd, &jump_2_64);
+ * </pre>
+ * @param step_hi upper 64 bits of jump step.
+ * @param step_lo lower 64 bits of jump step.
+ * @return jump polynomial
+ */
+constexpr xsadd_jump_poly_t xsadd_constexpr_jump_poly_u128(uint64_t step_hi,
+                                                           uint64_t step_lo) {
+    return xsadd_detail::to_jump_poly(
+        xsadd_detail::power_t_mod_phi(xsadd_detail::word128{step_lo,
+                                                            step_hi}));
+}
+
+/**
+ * This function calculates the jump polynomial of
+ * mul_step * base_step steps, the same as xsadd_calculate_jump_poly().
+ * As in xsadd_calculate_jump_poly(), only the first 32 digits of
+ * base_step are used, and the product mul_step * base_step is
+ * truncated to 128 bits before the jump polynomial is calculated.
+ * @param mul_step jump step is mul_step * base_step.
+ * @param base_step hexadecimal string, for example
+ * xsadd_constexpr_jump_base_step.
+ * @return jump polynomial
+ */
+constexpr xsadd_jump_poly_t xsadd_constexpr_jump_poly(uint32_t mul_step,
+                                                      const char * base_step) {
+    return xsadd_detail::to_jump_poly(
+        xsadd_detail::power_t_mod_phi(
+            xsadd_detail::mul_u32(
+                xsadd_detail::parse_hex(base_step,
+                                        xsadd_detail::word128{0, 0}, 32),
+                mul_step)));
+}
+
+#endif // XSADD_HPP
@@ -0,0 +1,1424 @@
+/**
+ * @file xsadd_dist.c
+ *
+ * @brief XORSHIFT-ADD: non-uniform distributions.
+ *
+ * @author Mutsuo Saito (Manieth Corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (c) 2014
+ * Mutsuo Saito, Makoto Matsumoto, Manieth Corp.,
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <xsadd_dist.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define XSADD_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+#define DOUBLE_MUL (1.0 / 9007199254740992.0)
+#define ABS_MASK UINT64_C(0x000fffffffffffff)
+/*
+ * number of 32-bit words generated at once by the bulk functions.
+ */
+#define DIST_BUFFER_SIZE 2048
+/*
+ * number of elements xsadd_alias_fill() generates at once, the size
+ * from which xsadd_fill_array_uint32() uses the eight lanes.
+ */
+#define ALIAS_CHUNK_SIZE (512 * 1024 / 4)
+/*
+ * how many elements ahead xsadd_alias_fill() prefetches table entries.
+ */
+#define ALIAS_PREFETCH_DISTANCE 16
+/*
+ * number of indices xsadd_shuffle() computes at once, large enough for
+ * xsadd_fill_array_uint32() to use the eight lanes, and how many swaps
+ * ahead it prefetches elements.
+ */
+#define SHUFFLE_BATCH_SIZE (512 * 1024 / 4)
+#define SHUFFLE_PREFETCH_DISTANCE 16
+#define RANGE32 (UINT64_C(1) << 32)
+/*
+ * largest range of which two indices are made from one 32-bit output.
+ */
+#define PAIR32_MAX 65536
+
+/* ===============
+ * ZIGGURAT TABLES
+   =============== */
+/*
+ * The tables are computed by the recursion of Marsaglia and Tsang,
+ * "The Ziggurat Method for Generating Random Variables", J. Stat.
+ * Softw. 5(8), 2000, with 256 layers of area v and abscissae scaled
+ * by 2^52:
+ *   x[255] = r, x[i - 1] = f^-1(v / x[i] + f(x[i])), x[0] = 0,
+ *   k[i] = 2^52 * x[i - 1] / x[i], w[i] = x[i] / 2^52, f[i] = f(x[i]),
+ * except for the base layer, which has the tail and is treated as a
+ * rectangle of width v / f(r):
+ *   k[0] = 2^52 * r f(r) / v, w[0] = v / (2^52 f(r)), f[0] = 1.
+ * For normal, f(x) = exp(-x^2 / 2) and v = r f(r) + the tail area
+ * sqrt(pi / 2) erfc(r / sqrt(2)). For exponential, f(x) = exp(-x)
+ * and v = (r + 1) f(r).
+ */
+#define NORMAL_R 3.6541528853610088
+#define NORMAL_R_INV (1.0 / NORMAL_R)
+#define EXP_R 7.6971174701310497
+
+static const uint64_t normal_k[256] = {
+    UINT64_C(0x0ef33d8025ef65), UINT64_C(0x00000000000000),
+    UINT64_C(0x0c08be98fbc6c9), UINT64_C(0x0da354fabd814c),
+    UINT64_C(0x0e51f67ec1eeef), UINT64_C(0x0eb255e9d3f780),
+    UINT64_C(0x0eef4b817ecaba), UINT64_C(0x0f19470afa44ac),
+    UINT64_C(0x0f37ed61ffcb18), UINT64_C(0x0f4f469561255b),
+    UINT64_C(0x0f61a5e41ba396), UINT64_C(0x0f707a755396a4),
+    UINT64_C(0x0f7cb2ec28449b), UINT64_C(0x0f86f10c6357d3),
+    UINT64_C(0x0f8fa6578325dd), UINT64_C(0x0f9724c74dd0da),
+    UINT64_C(0x0f9da907dbf508), UINT64_C(0x0fa360f581fa72),
+    UINT64_C(0x0fa86fde5b4bf8), UINT64_C(0x0facf160d354dc),
+    UINT64_C(0x0fb0fb6718b90e), UINT64_C(0x0fb49f8d5374c5),
+    UINT64_C(0x0fb7ec2366fe77), UINT64_C(0x0fbaece9a1e50c),
+    UINT64_C(0x0fbdab9d040bed), UINT64_C(0x0fc03060ff6c57),
+    UINT64_C(0x0fc2821037a248), UINT64_C(0x0fc4a67ae25bd1),
+    UINT64_C(0x0fc6a2977aee30), UINT64_C(0x0fc87aa92896a4),
+    UINT64_C(0x0fca325e4bde85), UINT64_C(0x0fcbcce902231a),
+    UINT64_C(0x0fcd4d12f839c4), UINT64_C(0x0fceb54d8fec99),
+    UINT64_C(0x0fd007bf1dc930), UINT64_C(0x0fd1464dd6c4e5),
+    UINT64_C(0x0fd272a8e2f450), UINT64_C(0x0fd38e4ff0c91e),
+    UINT64_C(0x0fd49a9990b479), UINT64_C(0x0fd598b8920f52),
+    UINT64_C(0x0fd689c08e99ec), UINT64_C(0x0fd76ea9c8e832),
+    UINT64_C(0x0fd848547b08e8), UINT64_C(0x0fd9178bad2c8b),
+    UINT64_C(0x0fd9dd07a7add2), UINT64_C(0x0fda9970105e8b),
+    UINT64_C(0x0fdb4d5dc02e1f), UINT64_C(0x0fdbf95c5bfcd0),
+    UINT64_C(0x0fdc9debb99a7d), UINT64_C(0x0fdd3b8118729d),
+    UINT64_C(0x0fddd288342f8f), UINT64_C(0x0fde6364369f63),
+    UINT64_C(0x0fdeee708d514e), UINT64_C(0x0fdf7401a6b42e),
+    UINT64_C(0x0fdff46599ed3e), UINT64_C(0x0fe06fe4bc24f1),
+    UINT64_C(0x0fe0e6c225a258), UINT64_C(0x0fe1593c28b84b),
+    UINT64_C(0x0fe1c78cbc3f98), UINT64_C(0x0fe231e9db1ca9),
+    UINT64_C(0x0fe29885da1b91), UINT64_C(0x0fe2fb8fb54186),
+    UINT64_C(0x0fe35b33558d4a), UINT64_C(0x0fe3b799d0002a),
+    UINT64_C(0x0fe410e99ead7e), UINT64_C(0x0fe46746d47734),
+    UINT64_C(0x0fe4bad34c095b), UINT64_C(0x0fe50baed29524),
+    UINT64_C(0x0fe559f74ebc77), UINT64_C(0x0fe5a5c8e41212),
+    UINT64_C(0x0fe5ef3e138689), UINT64_C(0x0fe6366fd91077),
+    UINT64_C(0x0fe67b75c6d578), UINT64_C(0x0fe6be661e11aa),
+    UINT64_C(0x0fe6ff55e5f4f2), UINT64_C(0x0fe73e5900a701),
+    UINT64_C(0x0fe77b823e9e39), UINT64_C(0x0fe7b6e37070a1),
+    UINT64_C(0x0fe7f08d774242), UINT64_C(0x0fe8289053f08c),
+    UINT64_C(0x0fe85efb35173b), UINT64_C(0x0fe893dc840864),
+    UINT64_C(0x0fe8c741f0cebc), UINT64_C(0x0fe8f9387d4ef6),
+    UINT64_C(0x0fe929cc879b1c), UINT64_C(0x0fe95909d388ea),
+    UINT64_C(0x0fe986fb939aa1), UINT64_C(0x0fe9b3ac714865),
+    UINT64_C(0x0fe9df2694b6d5), UINT64_C(0x0fea0973abe67b),
+    UINT64_C(0x0fea329cf166a4), UINT64_C(0x0fea5aab32952c),
+    UINT64_C(0x0fea81a6d57419), UINT64_C(0x0feaa797de1cef),
+    UINT64_C(0x0feacc85f3d91f), UINT64_C(0x0feaf07865e63c),
+    UINT64_C(0x0feb13762fec12), UINT64_C(0x0feb3585fe2a4a),
+    UINT64_C(0x0feb56ae3162b4), UINT64_C(0x0feb76f4e284f9),
+    UINT64_C(0x0feb965fe62013), UINT64_C(0x0febb4f4cf9d7c),
+    UINT64_C(0x0febd2b8f449cf), UINT64_C(0x0febefb16e2e3d),
+    UINT64_C(0x0fec0be31ebde8), UINT64_C(0x0fec2752b15a14),
+    UINT64_C(0x0fec42049dafd3), UINT64_C(0x0fec5bfd29f196),
+    UINT64_C(0x0fec75406ceef4), UINT64_C(0x0fec8dd2500cb4),
+    UINT64_C(0x0feca5b6911f10), UINT64_C(0x0fecbcf0c427fe),
+    UINT64_C(0x0fecd38454fb15), UINT64_C(0x0fece97488c8b3),
+    UINT64_C(0x0fecfec47f91b7), UINT64_C(0x0fed1377358528),
+    UINT64_C(0x0fed278f844903), UINT64_C(0x0fed3b10242f4c),
+    UINT64_C(0x0fed4dfbad586d), UINT64_C(0x0fed605498c3dc),
+    UINT64_C(0x0fed721d414fe8), UINT64_C(0x0fed8357e4a981),
+    UINT64_C(0x0fed9406a42cc8), UINT64_C(0x0feda42b85b704),
+    UINT64_C(0x0fedb3c8746ab3), UINT64_C(0x0fedc2df416652),
+    UINT64_C(0x0fedd171a46e52), UINT64_C(0x0feddf813c8ad2),
+    UINT64_C(0x0feded0f90997f), UINT64_C(0x0fedfa1e0fd413),
+    UINT64_C(0x0fee06ae124bc4), UINT64_C(0x0fee12c0d95a06),
+    UINT64_C(0x0fee1e579006df), UINT64_C(0x0fee29734b6524),
+    UINT64_C(0x0fee34150ae4bb), UINT64_C(0x0fee3e3db89b3c),
+    UINT64_C(0x0fee47ee2982f3), UINT64_C(0x0fee51271db086),
+    UINT64_C(0x0fee59e9407f41), UINT64_C(0x0fee623528b42d),
+    UINT64_C(0x0fee6a0b5897f0), UINT64_C(0x0fee716c3e077a),
+    UINT64_C(0x0fee7858327b81), UINT64_C(0x0fee7ecf7b06b9),
+    UINT64_C(0x0fee84d2484ab2), UINT64_C(0x0fee8a60b66342),
+    UINT64_C(0x0fee8f7accc851), UINT64_C(0x0fee94207e25da),
+    UINT64_C(0x0fee9851a829eb), UINT64_C(0x0fee9c0e13485b),
+    UINT64_C(0x0fee9f557273f3), UINT64_C(0x0feea22762ccae),
+    UINT64_C(0x0feea4836b42ab), UINT64_C(0x0feea668fc2d71),
+    UINT64_C(0x0feea7d76ed6f9), UINT64_C(0x0feea8ce04fa0a),
+    UINT64_C(0x0feea94be8333b), UINT64_C(0x0feea95029640f),
+    UINT64_C(0x0feea8d9c0075d), UINT64_C(0x0feea7e7897653),
+    UINT64_C(0x0feea678481d24), UINT64_C(0x0feea48aa29e82),
+    UINT64_C(0x0feea21d22e4d9), UINT64_C(0x0fee9f2e352024),
+    UINT64_C(0x0fee9bbc26af2e), UINT64_C(0x0fee97c524f2e3),
+    UINT64_C(0x0fee93473c0a39), UINT64_C(0x0fee8e40557515),
+    UINT64_C(0x0fee88ae369c79), UINT64_C(0x0fee828e7f3dfc),
+    UINT64_C(0x0fee7bdea7b887), UINT64_C(0x0fee749bff37ff),
+    UINT64_C(0x0fee6cc3a9bd5e), UINT64_C(0x0fee64529e007f),
+    UINT64_C(0x0fee5b45a32888), UINT64_C(0x0fee51994e57b5),
+    UINT64_C(0x0fee474a0006ce), UINT64_C(0x0fee3c53e12c4f),
+    UINT64_C(0x0fee30b2e02ad7), UINT64_C(0x0fee2462ad8204),
+    UINT64_C(0x0fee175eb83c59), UINT64_C(0x0fee09a22a1447),
+    UINT64_C(0x0fedfb27e349cb), UINT64_C(0x0fedebea76216c),
+    UINT64_C(0x0feddbe422047d), UINT64_C(0x0fedcb0ece39d3),
+    UINT64_C(0x0fedb964042cf3), UINT64_C(0x0feda6dce938c9),
+    UINT64_C(0x0fed937237e98c), UINT64_C(0x0fed7f1c38a836),
+    UINT64_C(0x0fed69d2b9c02a), UINT64_C(0x0fed538d06adff),
+    UINT64_C(0x0fed3c41dea422), UINT64_C(0x0fed23e76a2fd7),
+    UINT64_C(0x0fed0a732fe643), UINT64_C(0x0fecefda07fe33),
+    UINT64_C(0x0fecd4100eb7b8), UINT64_C(0x0fecb708956eb4),
+    UINT64_C(0x0fec98b61230c0), UINT64_C(0x0fec790a0da978),
+    UINT64_C(0x0fec57f50f31fd), UINT64_C(0x0fec356686c961),
+    UINT64_C(0x0fec114cb4b334), UINT64_C(0x0febeb948e6fd0),
+    UINT64_C(0x0febc429a0b691), UINT64_C(0x0feb9af5ee0cdc),
+    UINT64_C(0x0feb6fe1c98542), UINT64_C(0x0feb42d3ad1f9e),
+    UINT64_C(0x0feb13b00b2d4b), UINT64_C(0x0feae2591a02e8),
+    UINT64_C(0x0feaaeae992256), UINT64_C(0x0fea788d8ee326),
+    UINT64_C(0x0fea3fcffd73e5), UINT64_C(0x0fea044c8dd9f6),
+    UINT64_C(0x0fe9c5d62f563a), UINT64_C(0x0fe9843ba947a3),
+    UINT64_C(0x0fe93f471d4728), UINT64_C(0x0fe8f6bd76c5d6),
+    UINT64_C(0x0fe8aa5dc4e8e6), UINT64_C(0x0fe859e07ab1ea),
+    UINT64_C(0x0fe804f690a93f), UINT64_C(0x0fe7ab488233bf),
+    UINT64_C(0x0fe74c751f6aa5), UINT64_C(0x0fe6e8102aa201),
+    UINT64_C(0x0fe67da0b6abd8), UINT64_C(0x0fe60c9f38307d),
+    UINT64_C(0x0fe5947338f742), UINT64_C(0x0fe51470977280),
+    UINT64_C(0x0fe48bd436f457), UINT64_C(0x0fe3f9bffd1e37),
+    UINT64_C(0x0fe35d35eeb19b), UINT64_C(0x0fe2b5122fe4fd),
+    UINT64_C(0x0fe20003995557), UINT64_C(0x0fe13c82788314),
+    UINT64_C(0x0fe068c4ee67af), UINT64_C(0x0fdf82b02b71aa),
+    UINT64_C(0x0fde87c57efeaa), UINT64_C(0x0fdd7509c63bfd),
+    UINT64_C(0x0fdc46e529bf12), UINT64_C(0x0fdaf8f82e0282),
+    UINT64_C(0x0fd985e1b2ba75), UINT64_C(0x0fd7e6ef48cf04),
+    UINT64_C(0x0fd613adbd650b), UINT64_C(0x0fd40149e2f011),
+    UINT64_C(0x0fd1a1a7b4c7ac), UINT64_C(0x0fcee204761f9e),
+    UINT64_C(0x0fcba8d85e11b1), UINT64_C(0x0fc7d26ecd2d22),
+    UINT64_C(0x0fc32b2f1e22ec), UINT64_C(0x0fbd6581c0b839),
+    UINT64_C(0x0fb606c4005433), UINT64_C(0x0fac40582a2873),
+    UINT64_C(0x0f9e971e014597), UINT64_C(0x0f89fa48a41dfb),
+    UINT64_C(0x0f66c5f7f0302c), UINT64_C(0x0f1a5a4b331c49)
+};
+
+static const double normal_w[256] = {
+    8.68362706080131504e-16, 4.77933017572782434e-17, 6.35435241740531654e-17,
+    7.45487048124773942e-17, 8.32936681579313671e-17, 9.06806040505951680e-17,
+    9.71486007656779635e-17, 1.02947503142410488e-16, 1.08234302884477123e-16,
+    1.13114701961090604e-16, 1.17663594570229483e-16, 1.21936172787143880e-16,
+    1.25974399146371125e-16, 1.29810998862640513e-16, 1.33472037368241425e-16,
+    1.36978648425712230e-16, 1.40348230012424018e-16, 1.43595294520569652e-16,
+    1.46732087423644416e-16, 1.49769046683910589e-16, 1.52715150035962226e-16,
+    1.55578181694607886e-16, 1.58364940092909076e-16, 1.61081401752749526e-16,
+    1.63732852039698754e-16, 1.66323990584208550e-16, 1.68859017086766161e-16,
+    1.71341701765596780e-16, 1.73775443658648791e-16, 1.76163319230010182e-16,
+    1.78508123169767495e-16, 1.80812402857991695e-16, 1.83078487648267699e-16,
+    1.85308513886180387e-16, 1.87504446393739014e-16, 1.89668097007747793e-16,
+    1.91801140648386395e-16, 1.93905129306251234e-16, 1.95981504266288417e-16,
+    1.98031606831281912e-16, 2.00056687762733448e-16, 2.02057915620716662e-16,
+    2.04036384154802242e-16, 2.05993118874037211e-16, 2.07929082904140321e-16,
+    2.09845182223703665e-16, 2.11742270357603567e-16, 2.13621152594498829e-16,
+    2.15482589785814729e-16, 2.17327301775643798e-16, 2.19155970504272856e-16,
+    2.20969242822353324e-16, 2.22767733047895683e-16, 2.24552025294143750e-16,
+    2.26322675592856984e-16, 2.28080213834501904e-16, 2.29825145544247036e-16,
+    2.31557953510408234e-16, 2.33279099280043758e-16, 2.34989024534709748e-16,
+    2.36688152357916235e-16, 2.38376888404542632e-16, 2.40055621981350775e-16,
+    2.41724727046750400e-16, 2.43384563137110434e-16, 2.45035476226149688e-16,
+    2.46677799523270695e-16, 2.48311854216108916e-16, 2.49937950162045440e-16,
+    2.51556386532965934e-16, 2.53167452417135975e-16, 2.54771427381694615e-16,
+    2.56368581998939832e-16, 2.57959178339286871e-16, 2.59543470433517169e-16,
+    2.61121704706702087e-16, 2.62694120385972713e-16, 2.64260949884119099e-16,
+    2.65822419160830878e-16, 2.67378748063236477e-16, 2.68930150647261740e-16,
+    2.70476835481199667e-16, 2.72019005932773355e-16, 2.73556860440868057e-16,
+    2.75090592773016862e-16, 2.76620392269639180e-16, 2.78146444075954558e-16,
+    2.79668929362423104e-16, 2.81188025534502173e-16, 2.82703906432448022e-16,
+    2.84216742521840705e-16, 2.85726701075460199e-16, 2.87233946347098044e-16,
+    2.88738639737848241e-16, 2.90240939955384283e-16, 2.91741003166694603e-16,
+    2.93238983144718263e-16, 2.94735031409293588e-16, 2.96229297362806697e-16,
+    2.97721928420902990e-16, 2.99213070138601406e-16, 3.00702866332133202e-16,
+    3.02191459196806251e-16, 3.03678989421180283e-16, 3.05165596297822021e-16,
+    3.06651417830895550e-16, 3.08136590840829816e-16, 3.09621251066292352e-16,
+    3.11105533263689395e-16, 3.12589571304399991e-16, 3.14073498269944765e-16,
+    3.15557446545280212e-16, 3.17041547910403000e-16, 3.18525933630440747e-16,
+    3.20010734544401236e-16, 3.21496081152744804e-16, 3.22982103703941607e-16,
+    3.24468932280169877e-16, 3.25956696882307937e-16, 3.27445527514370770e-16,
+    3.28935554267537066e-16, 3.30426907403912937e-16, 3.31919717440175283e-16,
+    3.33414115231237295e-16, 3.34910232054077895e-16, 3.36408199691876557e-16,
+    3.37908150518595029e-16, 3.39410217584149013e-16, 3.40914534700312702e-16,
+    3.42421236527501915e-16, 3.43930458662583183e-16, 3.45442337727858451e-16,
+    3.46957011461378452e-16, 3.48474618808741469e-16, 3.49995300016538198e-16,
+    3.51519196727607540e-16, 3.53046452078274108e-16, 3.54577210797743671e-16,
+    3.56111619309838942e-16, 3.57649825837265150e-16, 3.59191980508603143e-16,
+    3.60738235468235335e-16, 3.62288744989419349e-16, 3.63843665590734636e-16,
+    3.65403156156137144e-16, 3.66967378058870238e-16, 3.68536495289491549e-16,
+    3.70110674588289983e-16, 3.71690085582382396e-16, 3.73274900927794451e-16,
+    3.74865296456848967e-16, 3.76461451331202918e-16, 3.78063548200896087e-16,
+    3.79671773369794475e-16, 3.81286316967837788e-16, 3.82907373130524367e-16,
+    3.84535140186095956e-16, 3.86169820850914927e-16, 3.87811622433558721e-16,
+    3.89460757048192621e-16, 3.91117441837820591e-16, 3.92781899208054203e-16,
+    3.94454357072087761e-16, 3.96135049107613543e-16, 3.97824215026468309e-16,
+    3.99522100857856502e-16, 4.01228959246062957e-16, 4.02945049763632842e-16,
+    4.04670639241075044e-16, 4.06406002114225039e-16, 4.08151420790493873e-16,
+    4.09907186035326643e-16, 4.11673597380302521e-16, 4.13450963554423501e-16,
+    4.15239602940268686e-16, 4.17039844056831440e-16, 4.18852026071011082e-16,
+    4.20676499339901412e-16, 4.22513625986204839e-16, 4.24363780509307747e-16,
+    4.26227350434779810e-16, 4.28104737005311666e-16, 4.29996355916383230e-16,
+    4.31902638100262945e-16, 4.33824030562279080e-16, 4.35760997273684901e-16,
+    4.37714020125858796e-16, 4.39683599951052137e-16, 4.41670257615420398e-16,
+    4.43674535190656727e-16, 4.45696997211204307e-16, 4.47738232024753387e-16,
+    4.49798853244554968e-16, 4.51879501313005876e-16, 4.53980845187003401e-16,
+    4.56103584156742305e-16, 4.58248449810956766e-16, 4.60416208163115380e-16,
+    4.62607661954784666e-16, 4.64823653154320836e-16, 4.67065065671263256e-16,
+    4.69332828309332989e-16, 4.71627917983835327e-16, 4.73951363232586912e-16,
+    4.76304248053313935e-16, 4.78687716104872481e-16, 4.81102975314741918e-16,
+    4.83551302941152712e-16, 4.86034051145081294e-16, 4.88552653135360442e-16,
+    4.91108629959527054e-16, 4.93703598024033553e-16, 4.96339277440398824e-16,
+    4.99017501309182246e-16, 5.01740226071809045e-16, 5.04509543081872847e-16,
+    5.07327691573354306e-16, 5.10197073234156184e-16, 5.13120268630678373e-16,
+    5.16100055774322825e-16, 5.19139431175769958e-16, 5.22241633800023527e-16,
+    5.25410172417759733e-16, 5.28648856950494511e-16, 5.31961834533840038e-16,
+    5.35353631181649688e-16, 5.38829200133405320e-16, 5.42393978220171234e-16,
+    5.46053951907478140e-16, 5.49815735089281411e-16, 5.53686661246787600e-16,
+    5.57674893292657746e-16, 5.61789555355541666e-16, 5.66040892008242315e-16,
+    5.70440462129139007e-16, 5.75001376891989622e-16, 5.79738594572459464e-16,
+    5.84669289345547999e-16, 5.89813317647790041e-16, 5.95193814964144514e-16,
+    6.00837969627190931e-16, 6.06778040933344851e-16, 6.13052720872528061e-16,
+    6.19708989458162555e-16, 6.26804696330128341e-16, 6.34412240712750500e-16,
+    6.42623965954805442e-16, 6.51560331734499258e-16, 6.61382788509766317e-16,
+    6.72315046250558663e-16, 6.84680341756425876e-16, 6.98971833638761995e-16,
+    7.15999493483066422e-16, 7.37242430179879792e-16, 7.65893637080557177e-16,
+    8.11384933765648419e-16
+};
+
+static const double normal_f[256] = {
+    1.00000000000000000e+00, 9.77101701267670819e-01, 9.59879091800105999e-01,
+    9.45198953442298984e-01, 9.32060075959229906e-01, 9.19991505039346458e-01,
+    9.08726440052130324e-01, 8.98095921898342864e-01, 8.87984660755832822e-01,
+    8.78309655808916845e-01, 8.69008688036856491e-01, 8.60033621196330977e-01,
+    8.51346258458677507e-01, 8.42915653112203733e-01, 8.34716292986882991e-01,
+    8.26726833946220929e-01, 8.18929191603701812e-01, 8.11307874312655719e-01,
+    8.03849483170963830e-01, 7.96542330422958411e-01, 7.89376143566024036e-01,
+    7.82341832654801950e-01, 7.75431304981186620e-01, 7.68637315798485710e-01,
+    7.61953346836794720e-01, 7.55373506507095560e-01, 7.48892447219156376e-01,
+    7.42505296340150611e-01, 7.36207598126862095e-01, 7.29995264561475676e-01,
+    7.23864533468629667e-01, 7.17811932630721405e-01, 7.11834248878247866e-01,
+    7.05928501332753755e-01, 7.00091918136511060e-01, 6.94321916126116268e-01,
+    6.88616083004671253e-01, 6.82972161644994302e-01, 6.77388036218772971e-01,
+    6.71861719897081655e-01, 6.66391343908749656e-01, 6.60975147776662775e-01,
+    6.55611470579696931e-01, 6.50298743110816369e-01, 6.45035480820821960e-01,
+    6.39820277453056141e-01, 6.34651799287623164e-01, 6.29528779924836246e-01,
+    6.24450015547026061e-01, 6.19414360605833991e-01, 6.14420723888913445e-01,
+    6.09468064925773101e-01, 6.04555390697467332e-01, 5.99681752619124819e-01,
+    5.94846243767986893e-01, 5.90047996332825453e-01, 5.85286179263370787e-01,
+    5.80559996100790343e-01, 5.75868682972353163e-01, 5.71211506735252672e-01,
+    5.66587763256163890e-01, 5.61996775814523897e-01, 5.57437893618765501e-01,
+    5.52910490425831846e-01, 5.48413963255265369e-01, 5.43947731190025818e-01,
+    5.39511234256951577e-01, 5.35103932380457170e-01, 5.30725304403661502e-01,
+    5.26374847171683924e-01, 5.22052074672321398e-01, 5.17756517229755908e-01,
+    5.13487720747326515e-01, 5.09245245995747609e-01, 5.05028667943467791e-01,
+    5.00837575126148349e-01, 4.96671569052489326e-01, 4.92530263643868149e-01,
+    4.88413284705457584e-01, 4.84320269426682881e-01, 4.80250865909046365e-01,
+    4.76204732719505475e-01, 4.72181538467729756e-01, 4.68180961405693208e-01,
+    4.64202689048173911e-01, 4.60246417812842479e-01, 4.56311852678716101e-01,
+    4.52398706861848243e-01, 4.48506701507202732e-01, 4.44635565395739119e-01,
+    4.40785034665803765e-01, 4.36954852547985328e-01, 4.33144769112652095e-01,
+    4.29354541029441261e-01, 4.25583931338021748e-01, 4.21832709229495728e-01,
+    4.18100649837847949e-01, 4.14387534040890904e-01, 4.10693148270187991e-01,
+    4.07017284329473150e-01, 4.03359739221114288e-01, 3.99720314980197000e-01,
+    3.96098818515832174e-01, 3.92495061459315342e-01, 3.88908860018788549e-01,
+    3.85340034840077061e-01, 3.81788410873393436e-01, 3.78253817245618906e-01,
+    3.74736087137890861e-01, 3.71235057668239221e-01, 3.67750569779032255e-01,
+    3.64282468129003723e-01, 3.60830600989647754e-01, 3.57394820145780223e-01,
+    3.53974980800076555e-01, 3.50570941481405884e-01, 3.47182563956793477e-01,
+    3.43809713146850549e-01, 3.40452257044521645e-01, 3.37110066637005878e-01,
+    3.33783015830718233e-01, 3.30470981379163420e-01, 3.27173842813601290e-01,
+    3.23891482376391038e-01, 3.20623784956905300e-01, 3.17370638029913443e-01,
+    3.14131931596337066e-01, 3.10907558126286343e-01, 3.07697412504291890e-01,
+    3.04501391976649827e-01, 3.01319396100802883e-01, 2.98151326696685315e-01,
+    2.94997087799961644e-01, 2.91856585617094988e-01, 2.88729728482182701e-01,
+    2.85616426815501590e-01, 2.82516593083707412e-01, 2.79430141761637718e-01,
+    2.76356989295668098e-01, 2.73297054068576906e-01, 2.70250256365875186e-01,
+    2.67216518343561138e-01, 2.64195763997260802e-01, 2.61187919132720825e-01,
+    2.58192911337618902e-01, 2.55210669954661684e-01, 2.52241126055941900e-01,
+    2.49284212418528245e-01, 2.46339863501263634e-01, 2.43408015422750118e-01,
+    2.40488605940500394e-01, 2.37581574431237952e-01, 2.34686861872329872e-01,
+    2.31804410824338586e-01, 2.28934165414680230e-01, 2.26076071322380195e-01,
+    2.23230075763917429e-01, 2.20396127480151943e-01, 2.17574176724331131e-01,
+    2.14764175251173584e-01, 2.11966076307030155e-01, 2.09179834621124994e-01,
+    2.06405406397880714e-01, 2.03642749310334853e-01, 2.00891822494656563e-01,
+    1.98152586545775111e-01, 1.95425003514134277e-01, 1.92709036903589120e-01,
+    1.90004651670464958e-01, 1.87311814223800249e-01, 1.84630492426799270e-01,
+    1.81960655599522542e-01, 1.79302274522847638e-01, 1.76655321443734997e-01,
+    1.74019770081838748e-01, 1.71395595637505949e-01, 1.68782774801211510e-01,
+    1.66181285764482045e-01, 1.63591108232365695e-01, 1.61012223437511065e-01,
+    1.58444614155924313e-01, 1.55888264724479197e-01, 1.53343161060262828e-01,
+    1.50809290681845676e-01, 1.48286642732574525e-01, 1.45775208005994028e-01,
+    1.43274978973513406e-01, 1.40785949814444672e-01, 1.38308116448550705e-01,
+    1.35841476571253728e-01, 1.33386029691669128e-01, 1.30941777173644303e-01,
+    1.28508722279999515e-01, 1.26086870220185859e-01, 1.23676228201596544e-01,
+    1.21276805484790209e-01, 1.18888613442909977e-01, 1.16511665625610800e-01,
+    1.14145977827838349e-01, 1.11791568163837993e-01, 1.09448457146811631e-01,
+    1.07116667774683635e-01, 1.04796225622486888e-01, 1.02487158941935080e-01,
+    1.00189498768809809e-01, 9.79032790388622842e-02, 9.56285367130088187e-02,
+    9.33653119126908598e-02, 9.11136480663736342e-02, 8.88735920682757891e-02,
+    8.66451944505579608e-02, 8.44285095703533606e-02, 8.22235958132028627e-02,
+    8.00305158146630558e-02, 7.78493367020960392e-02, 7.56801303589270669e-02,
+    7.35229737139812684e-02, 7.13779490588903748e-02, 6.92451443970067693e-02,
+    6.71246538277884830e-02, 6.50165779712428421e-02, 6.29210244377581135e-02,
+    6.08381083495398642e-02, 5.87679529209337581e-02, 5.67106901062028948e-02,
+    5.46664613248889139e-02, 5.26354182767921758e-02, 5.06177238609477609e-02,
+    4.86135532158685213e-02, 4.66230949019303675e-02, 4.46465522512944427e-02,
+    4.26841449164744313e-02, 4.07361106559409256e-02, 3.88027074045261128e-02,
+    3.68842156885672845e-02, 3.49809414617160835e-02, 3.30932194585785155e-02,
+    3.12214171919202449e-02, 2.93659397581333137e-02, 2.75272356696030819e-02,
+    2.57058040085488965e-02, 2.39022033057958785e-02, 2.21170627073088641e-02,
+    2.03510962300445172e-02, 1.86051212757246433e-02, 1.68800831525431662e-02,
+    1.51770883079353248e-02, 1.34974506017398795e-02, 1.18427578579078877e-02,
+    1.02149714397014712e-02, 8.61658276939873159e-03, 7.05087547137322589e-03,
+    5.52240329925099676e-03, 4.03797259336303050e-03, 2.60907274610216273e-03,
+    1.26028593049859754e-03
+};
+
+static const uint64_t exp_k[256] = {
+    UINT64_C(0x0e290a13924be3), UINT64_C(0x00000000000000),
+    UINT64_C(0x09beadebce18c1), UINT64_C(0x0c377ac71f9e08),
+    UINT64_C(0x0d4ddb99075857), UINT64_C(0x0de893fb8ca23e),
+    UINT64_C(0x0e4a8e87c4328d), UINT64_C(0x0e8dff16ae1cba),
+    UINT64_C(0x0ebf2deab58c59), UINT64_C(0x0ee49a6e8b9638),
+    UINT64_C(0x0f0204efd64ee5), UINT64_C(0x0f19bdb8ea3c1b),
+    UINT64_C(0x0f2d458bbe5bd1), UINT64_C(0x0f3da104b78236),
+    UINT64_C(0x0f4b86d784571f), UINT64_C(0x0f577ad8a7784f),
+    UINT64_C(0x0f61de83da32ab), UINT64_C(0x0f6afb7843cce7),
+    UINT64_C(0x0f730a57372b44), UINT64_C(0x0f7a37651b0e68),
+    UINT64_C(0x0f80a5bb6eea52), UINT64_C(0x0f867189d3cb5b),
+    UINT64_C(0x0f8bb1b4f8fbbd), UINT64_C(0x0f9079062292b8),
+    UINT64_C(0x0f94d70ca8d43a), UINT64_C(0x0f98d8c7dcaa99),
+    UINT64_C(0x0f9c8928abe083), UINT64_C(0x0f9ff175b734a6),
+    UINT64_C(0x0fa319996bc47d), UINT64_C(0x0fa6085f8e9d07),
+    UINT64_C(0x0fa8c3a62e1991), UINT64_C(0x0fab5084e1f660),
+    UINT64_C(0x0fadb36c84cccb), UINT64_C(0x0faff041086846),
+    UINT64_C(0x0fb20a6ea22bb9), UINT64_C(0x0fb404fb42cb3c),
+    UINT64_C(0x0fb5e295158173), UINT64_C(0x0fb7a59e99727a),
+    UINT64_C(0x0fb95038c8789d), UINT64_C(0x0fbae44ba684eb),
+    UINT64_C(0x0fbc638d822e60), UINT64_C(0x0fbdcf89209ffa),
+    UINT64_C(0x0fbf29a303cfc5), UINT64_C(0x0fc0731df1089c),
+    UINT64_C(0x0fc1ad1ed6c8b1), UINT64_C(0x0fc2d8b02b5c89),
+    UINT64_C(0x0fc3f6c4d92131), UINT64_C(0x0fc5083ac9ba7d),
+    UINT64_C(0x0fc60ddd1e9cd6), UINT64_C(0x0fc7086622e825),
+    UINT64_C(0x0fc7f881009f0b), UINT64_C(0x0fc8decb41ac70),
+    UINT64_C(0x0fc9bbd623d7ec), UINT64_C(0x0fca9027c5b26d),
+    UINT64_C(0x0fcb5c3c319c49), UINT64_C(0x0fcc20864b4449),
+    UINT64_C(0x0fccdd70a35d40), UINT64_C(0x0fcd935e34bf80),
+    UINT64_C(0x0fce42ab0db8bd), UINT64_C(0x0fceebace7ec01),
+    UINT64_C(0x0fcf8eb3b0d0e7), UINT64_C(0x0fd02c0a049b60),
+    UINT64_C(0x0fd0c3f59d199c), UINT64_C(0x0fd156b7b5e27e),
+    UINT64_C(0x0fd1e48d670341), UINT64_C(0x0fd26daff73551),
+    UINT64_C(0x0fd2f2552684be), UINT64_C(0x0fd372af7233c1),
+    UINT64_C(0x0fd3eeee528f62), UINT64_C(0x0fd4673e73543a),
+    UINT64_C(0x0fd4dbc9e72ff7), UINT64_C(0x0fd54cb856dc2c),
+    UINT64_C(0x0fd5ba2f2c4119), UINT64_C(0x0fd62451ba02c2),
+    UINT64_C(0x0fd68b415fcff4), UINT64_C(0x0fd6ef1dabc160),
+    UINT64_C(0x0fd75004790eb6), UINT64_C(0x0fd7ae120c583f),
+    UINT64_C(0x0fd809612dbd09), UINT64_C(0x0fd8620b40effa),
+    UINT64_C(0x0fd8b8285b78fd), UINT64_C(0x0fd90bcf594b1d),
+    UINT64_C(0x0fd95d15efd425), UINT64_C(0x0fd9ac10bfa70c),
+    UINT64_C(0x0fd9f8d364df06), UINT64_C(0x0fda437086566b),
+    UINT64_C(0x0fda8bf9e3c9fe), UINT64_C(0x0fdad28062fed5),
+    UINT64_C(0x0fdb17141bff2c), UINT64_C(0x0fdb59c4648085),
+    UINT64_C(0x0fdb9a9fda83cc), UINT64_C(0x0fdbd9b46e3ed4),
+    UINT64_C(0x0fdc170f6b5d04), UINT64_C(0x0fdc52bd81a3fb),
+    UINT64_C(0x0fdc8ccacd07ba), UINT64_C(0x0fdcc542dd3902),
+    UINT64_C(0x0fdcfc30bcb793), UINT64_C(0x0fdd319ef77143),
+    UINT64_C(0x0fdd6597a0f60b), UINT64_C(0x0fdd98245a48a2),
+    UINT64_C(0x0fddc94e575271), UINT64_C(0x0fddf91e64014f),
+    UINT64_C(0x0fde279ce914ca), UINT64_C(0x0fde54d1f0a06a),
+    UINT64_C(0x0fde80c52a47cf), UINT64_C(0x0fdeab7def394e),
+    UINT64_C(0x0fded50345eb35), UINT64_C(0x0fdefd5be59fa0),
+    UINT64_C(0x0fdf248e39b26f), UINT64_C(0x0fdf4aa064b4af),
+    UINT64_C(0x0fdf6f98435894), UINT64_C(0x0fdf937b6f30ba),
+    UINT64_C(0x0fdfb64f414571), UINT64_C(0x0fdfd818d48262),
+    UINT64_C(0x0fdff8dd07fed8), UINT64_C(0x0fe018a08122c4),
+    UINT64_C(0x0fe03767adaa59), UINT64_C(0x0fe05536c58a13),
+    UINT64_C(0x0fe07211ccb4c5), UINT64_C(0x0fe08dfc94c532),
+    UINT64_C(0x0fe0a8fabe8ca1), UINT64_C(0x0fe0c30fbb87a5),
+    UINT64_C(0x0fe0dc3ecf3a5a), UINT64_C(0x0fe0f48b107521),
+    UINT64_C(0x0fe10bf76a82ef), UINT64_C(0x0fe122869e41ff),
+    UINT64_C(0x0fe1383b4327e1), UINT64_C(0x0fe14d17c83187),
+    UINT64_C(0x0fe1611e74c023), UINT64_C(0x0fe1745169635a),
+    UINT64_C(0x0fe186b2a09176), UINT64_C(0x0fe19843ef4e07),
+    UINT64_C(0x0fe1a90705bf63), UINT64_C(0x0fe1b8fd6fb37c),
+    UINT64_C(0x0fe1c828951443), UINT64_C(0x0fe1d689ba4bfd),
+    UINT64_C(0x0fe1e4220099a4), UINT64_C(0x0fe1f0f26655a0),
+    UINT64_C(0x0fe1fcfbc726d4), UINT64_C(0x0fe2083edc2830),
+    UINT64_C(0x0fe212bc3bfeb4), UINT64_C(0x0fe21c745adfe3),
+    UINT64_C(0x0fe225678a8895), UINT64_C(0x0fe22d95fa23f4),
+    UINT64_C(0x0fe234ffb62282), UINT64_C(0x0fe23ba4a800d9),
+    UINT64_C(0x0fe2418495fddc), UINT64_C(0x0fe2469f22bffb),
+    UINT64_C(0x0fe24af3cce90d), UINT64_C(0x0fe24e81ee9858),
+    UINT64_C(0x0fe25148bcda19), UINT64_C(0x0fe253474703fe),
+    UINT64_C(0x0fe2547c75fdc6), UINT64_C(0x0fe254e70b754f),
+    UINT64_C(0x0fe25485a0fd1a), UINT64_C(0x0fe25356a71450),
+    UINT64_C(0x0fe2515864173a), UINT64_C(0x0fe24e88f316f1),
+    UINT64_C(0x0fe24ae64296fa), UINT64_C(0x0fe2466e132f60),
+    UINT64_C(0x0fe2411df611bd), UINT64_C(0x0fe23af34b6f73),
+    UINT64_C(0x0fe233eb40bf41), UINT64_C(0x0fe22c02cee01b),
+    UINT64_C(0x0fe22336b81710), UINT64_C(0x0fe2198385e5cc),
+    UINT64_C(0x0fe20ee586b707), UINT64_C(0x0fe20358cb5dfb),
+    UINT64_C(0x0fe1f6d92465b1), UINT64_C(0x0fe1e9621f2c9e),
+    UINT64_C(0x0fe1daef02c8da), UINT64_C(0x0fe1cb7accb0a6),
+    UINT64_C(0x0fe1bb002d22c9), UINT64_C(0x0fe1a9798349b8),
+    UINT64_C(0x0fe196e0d9140c), UINT64_C(0x0fe1832fdebc44),
+    UINT64_C(0x0fe16e5fe5f931), UINT64_C(0x0fe15869dccfcf),
+    UINT64_C(0x0fe1414647fe78), UINT64_C(0x0fe128ed3cf8b2),
+    UINT64_C(0x0fe10f565b69cf), UINT64_C(0x0fe0f478c633ab),
+    UINT64_C(0x0fe0d84b1bdd9e), UINT64_C(0x0fe0bac36e6688),
+    UINT64_C(0x0fe09bd73a6b5b), UINT64_C(0x0fe07b7b5d920a),
+    UINT64_C(0x0fe059a40c26d2), UINT64_C(0x0fe03644c5d7f8),
+    UINT64_C(0x0fe011504979b2), UINT64_C(0x0fdfeab887b95c),
+    UINT64_C(0x0fdfc26e94a447), UINT64_C(0x0fdf986297e305),
+    UINT64_C(0x0fdf6c83bb8663), UINT64_C(0x0fdf3ec0193eed),
+    UINT64_C(0x0fdf0f04a5d30a), UINT64_C(0x0fdedd3d1aa204),
+    UINT64_C(0x0fdea953dcfc13), UINT64_C(0x0fde7331e3100d),
+    UINT64_C(0x0fde3abe9626f2), UINT64_C(0x0fddffdfb1dbd5),
+    UINT64_C(0x0fddc2791ff351), UINT64_C(0x0fdd826cd068c6),
+    UINT64_C(0x0fdd3f9a8d3856), UINT64_C(0x0fdcf9dfc95b0c),
+    UINT64_C(0x0fdcb1176a55fe), UINT64_C(0x0fdc65198ba50b),
+    UINT64_C(0x0fdc15bb3b2daa), UINT64_C(0x0fdbc2ce2dc4ae),
+    UINT64_C(0x0fdb6c206aaaca), UINT64_C(0x0fdb117becb4a1),
+    UINT64_C(0x0fdab2a6379bf0), UINT64_C(0x0fda4f5fdfb4e9),
+    UINT64_C(0x0fd9e76401f3a3), UINT64_C(0x0fd97a67a9ce1f),
+    UINT64_C(0x0fd90819221429), UINT64_C(0x0fd8901f2d4b02),
+    UINT64_C(0x0fd812182170e1), UINT64_C(0x0fd78d98e23cd3),
+    UINT64_C(0x0fd7022bb3f082), UINT64_C(0x0fd66f4edf96b9),
+    UINT64_C(0x0fd5d473200305), UINT64_C(0x0fd530f9ccff94),
+    UINT64_C(0x0fd48432b7b351), UINT64_C(0x0fd3cd59a8469e),
+    UINT64_C(0x0fd30b9368f90a), UINT64_C(0x0fd23dea45f500),
+    UINT64_C(0x0fd16349e2e04a), UINT64_C(0x0fd07a7a3ef98a),
+    UINT64_C(0x0fcf8219b5df05), UINT64_C(0x0fce7895bcfcde),
+    UINT64_C(0x0fcd5c220ad5e2), UINT64_C(0x0fcc2aadbc17dc),
+    UINT64_C(0x0fcae1d5e81fbc), UINT64_C(0x0fc97ed4e778f9),
+    UINT64_C(0x0fc7fe6d4d720e), UINT64_C(0x0fc65ccf39c2fc),
+    UINT64_C(0x0fc4957623cb03), UINT64_C(0x0fc2a2fc826dc7),
+    UINT64_C(0x0fc07ee19b01cd), UINT64_C(0x0fbe213c1cf493),
+    UINT64_C(0x0fbb8051ac1566), UINT64_C(0x0fb890078d120e),
+    UINT64_C(0x0fb5411a5b9a95), UINT64_C(0x0fb18000547133),
+    UINT64_C(0x0fad334827f1e2), UINT64_C(0x0fa839276708b9),
+    UINT64_C(0x0fa263b32e37ed), UINT64_C(0x0f9b72d1c52cd1),
+    UINT64_C(0x0f930a1a281a05), UINT64_C(0x0f889f023d820a),
+    UINT64_C(0x0f7b577d2be5f3), UINT64_C(0x0f69c650c40a8f),
+    UINT64_C(0x0f51530f0916d8), UINT64_C(0x0f2cb0e3c5933e),
+    UINT64_C(0x0eeefb15d605d8), UINT64_C(0x0e6da6ecf27460)
+};
+
+static const double exp_w[256] = {
+    1.93114801264183660e-15, 1.41780284879108441e-17, 2.32788249933824599e-17,
+    3.04878302470643326e-17, 3.66656977144748907e-17, 4.21793021892897388e-17,
+    4.72225615568627701e-17, 5.19119154462178852e-17, 5.63234710839550468e-17,
+    6.05100826064276466e-17, 6.45101650967275056e-17, 6.83526468037005407e-17,
+    7.20599395746890621e-17, 7.56498155373929933e-17, 7.91366439619510769e-17,
+    8.25322355635189409e-17, 8.58464361688505126e-17, 8.90875548656474283e-17,
+    9.22626796296637310e-17, 9.53779145052927188e-17, 9.84385608745592569e-17,
+    1.01449258090062940e-16, 1.04414094055853435e-16, 1.07336693234363844e-16,
+    1.10220287456701894e-16, 1.13067773464793343e-16, 1.15881760097055332e-16,
+    1.18664607304178862e-16, 1.21418458656943591e-16, 1.24145268623263870e-16,
+    1.26846825606061555e-16, 1.29524771519122842e-16, 1.32180618515388129e-16,
+    1.34815763357454470e-16, 1.37431499823676273e-16, 1.40029029468078617e-16,
+    1.42609470993212868e-16, 1.45173868448292992e-16, 1.47723198427635840e-16,
+    1.50258376414474562e-16, 1.52780262391016516e-16, 1.55289665815956962e-16,
+    1.57787350054595811e-16, 1.60274036333509089e-16, 1.62750407280835244e-16,
+    1.65217110104200763e-16, 1.67674759450782788e-16, 1.70123939987706463e-16,
+    1.72565208735682260e-16, 1.74999097184323675e-16, 1.77426113213805070e-16,
+    1.79846742844307141e-16, 1.82261451831958208e-16, 1.84670687127635762e-16,
+    1.87074878212982579e-16, 1.89474438326259016e-16, 1.91869765589159971e-16,
+    1.94261244044430424e-16, 1.96649244612990227e-16, 1.99034125978301438e-16,
+    2.01416235404858986e-16, 2.03795909496938816e-16, 2.06173474903084391e-16,
+    2.08549248971237711e-16, 2.10923540358915281e-16, 2.13296649602382940e-16,
+    2.15668869648389724e-16, 2.18040486351670095e-16, 2.20411778941115622e-16,
+    2.22783020457239500e-16, 2.25154478163313498e-16, 2.27526413932336941e-16,
+    2.29899084611801860e-16, 2.32272742368043662e-16, 2.34647635011809158e-16,
+    2.37024006306533887e-16, 2.39402096260693032e-16, 2.41782141405477104e-16,
+    2.44164375058941230e-16, 2.46549027577683039e-16, 2.48936326597022505e-16,
+    2.51326497260579703e-16, 2.53719762440079508e-16, 2.56116342946149876e-16,
+    2.58516457730823910e-16, 2.60920324082405769e-16, 2.63328157813314516e-16,
+    2.65740173441476178e-16, 2.68156584365799887e-16, 2.70577603036235092e-16,
+    2.73003441118879554e-16, 2.75434309656576242e-16, 2.77870419225412784e-16,
+    2.80311980087514308e-16, 2.82759202340497038e-16, 2.85212296063933089e-16,
+    2.87671471463158036e-16, 2.90136939010737537e-16, 2.92608909585895144e-16,
+    2.95087594612190327e-16, 2.97573206193725213e-16, 3.00065957250147390e-16,
+    3.02566061650707885e-16, 3.05073734347625110e-16, 3.07589191508999387e-16,
+    3.10112650651515430e-16, 3.12644330773167501e-16, 3.15184452486235228e-16,
+    3.17733238150736830e-16, 3.20290912008583347e-16, 3.22857700318655732e-16,
+    3.25433831493026100e-16, 3.28019536234543590e-16, 3.30615047676007382e-16,
+    3.33220601521148413e-16, 3.35836436187645773e-16, 3.38462792952404453e-16,
+    3.41099916099325966e-16, 3.43748053069806331e-16, 3.46407454616201674e-16,
+    3.49078374958506795e-16, 3.51761071944498276e-16, 3.54455807213601298e-16,
+    3.57162846364746524e-16, 3.59882459128492744e-16, 3.62614919543700312e-16,
+    3.65360506139050453e-16, 3.68119502119717566e-16, 3.70892195559513892e-16,
+    3.73678879598838537e-16, 3.76479852648778410e-16, 3.79295418601723344e-16,
+    3.82125887048875307e-16, 3.84971573505048764e-16, 3.87832799641179884e-16,
+    3.90709893524981826e-16, 3.93603189870207476e-16, 3.96513030295003809e-16,
+    3.99439763589868416e-16, 4.02383745995746934e-16, 4.05345341492839658e-16,
+    4.08324922100717804e-16, 4.11322868190383575e-16, 4.14339568808947407e-16,
+    4.17375422017631994e-16, 4.20430835243858558e-16, 4.23506225648215183e-16,
+    4.26602020507155817e-16, 4.29718657612332663e-16, 4.32856585687520945e-16,
+    4.36016264824156805e-16, 4.39198166936574146e-16, 4.42402776238099188e-16,
+    4.45630589739236109e-16, 4.48882117769261718e-16, 4.52157884522634748e-16,
+    4.55458428631724207e-16, 4.58784303767462271e-16, 4.62136079269642664e-16,
+    4.65514340808706923e-16, 4.68919691080991572e-16, 4.72352750539554799e-16,
+    4.75814158162855340e-16, 4.79304572263724704e-16, 4.82824671341258655e-16,
+    4.86375154978451191e-16, 4.89956744788614043e-16, 4.93570185413857748e-16,
+    4.97216245579170344e-16, 5.00895719205911408e-16, 5.04609426588843403e-16,
+    5.08358215641162445e-16, 5.12142963212354152e-16, 5.15964576484106179e-16,
+    5.19823994449949383e-16, 5.23722189484784844e-16, 5.27660169010988565e-16,
+    5.31638977268369024e-16, 5.35659697195905033e-16, 5.39723452433897885e-16,
+    5.43831409455963700e-16, 5.47984779841162965e-16, 5.52184822697523425e-16,
+    5.56432847249287216e-16, 5.60730215601396693e-16, 5.65078345696050637e-16,
+    5.69478714477634818e-16, 5.73932861283963536e-16, 5.78442391483599120e-16,
+    5.83008980381058637e-16, 5.87634377414005727e-16, 5.92320410669093137e-16,
+    5.97068991746009055e-16, 6.01882121002523628e-16, 6.06761893217000683e-16,
+    6.11710503708972175e-16, 6.16730254963062001e-16, 6.21823563806853269e-16,
+    6.26992969199332624e-16, 6.32241140693421147e-16, 6.37570887643942623e-16,
+    6.42985169241359472e-16, 6.48487105461890328e-16, 6.54079989036448088e-16,
+    6.59767298554456630e-16, 6.65552712834334282e-16, 6.71440126710648815e-16,
+    6.77433668409101032e-16, 6.83537718705127399e-16, 6.89756932090684778e-16,
+    6.96096260207488457e-16, 7.02560977844595884e-16, 7.09156711844958373e-16,
+    7.15889473320855308e-16, 7.22765693643812119e-16, 7.29792264752908509e-16,
+    7.36976584419124264e-16, 7.44326607216041458e-16, 7.51850902083251306e-16,
+    7.59558717533774877e-16, 7.67460055757842737e-16, 7.75565757121579058e-16,
+    7.83887596862285773e-16, 7.92438396157354999e-16, 8.01232150211308338e-16,
+    8.10284176591314635e-16, 8.19611287780612502e-16, 8.29231992858180916e-16,
+    8.39166734414679785e-16, 8.49438168364877010e-16, 8.60071496333494140e-16,
+    8.71094862938790402e-16, 8.82539833807213981e-16, 8.94441974851986457e-16,
+    9.06841559713166896e-16, 9.19784440981186494e-16, 9.33323132942295156e-16,
+    9.47518170652498405e-16, 9.62439834565847587e-16, 9.78170365478441980e-16,
+    9.94806847238387951e-16, 1.01246501442883194e-15, 1.03128436577561659e-15,
+    1.05143516040445497e-15, 1.07312819542240432e-15, 1.09662880685174078e-15,
+    1.12227749093503192e-15, 1.15052129630066634e-15, 1.18196352833042060e-15,
+    1.21744628323618153e-15, 1.25819580697551141e-15, 1.30609841071280816e-15,
+    1.36427861580578573e-15, 1.43848899321787231e-15, 1.54121907000641935e-15,
+    1.70910340771680548e-15
+};
+
+static const double exp_f[256] = {
+    1.00000000000000000e+00, 9.38143680862174589e-01, 9.00469929925746371e-01,
+    8.71704332381203595e-01, 8.47785500623989607e-01, 8.26993296643050324e-01,
+    8.08421651523008378e-01, 7.91527636972495618e-01, 7.75956852040115552e-01,
+    7.61463388849896172e-01, 7.47868621985195103e-01, 7.35038092431423484e-01,
+    7.22867659593572021e-01, 7.11274760805076012e-01, 7.00192655082788162e-01,
+    6.89566496117077987e-01, 6.79350572264765362e-01, 6.69506316731924733e-01,
+    6.60000841078999700e-01, 6.50805833414570989e-01, 6.41896716427266090e-01,
+    6.33251994214366065e-01, 6.24852738703665866e-01, 6.16682180915207656e-01,
+    6.08725382079622013e-01, 6.00968966365232227e-01, 5.93400901691733429e-01,
+    5.86010318477268033e-01, 5.78787358602845026e-01, 5.71723048664825817e-01,
+    5.64809192912400171e-01, 5.58038282262587448e-01, 5.51403416540641289e-01,
+    5.44898237672439612e-01, 5.38516872002861802e-01, 5.32253880263043211e-01,
+    5.26104213983619728e-01, 5.20063177368233598e-01, 5.14126393814748561e-01,
+    5.08289776410642880e-01, 5.02549501841347723e-01, 4.96901987241549548e-01,
+    4.91343869594032534e-01, 4.85871987341884914e-01, 4.80483363930454210e-01,
+    4.75175193037377375e-01, 4.69944825283959977e-01, 4.64789756250426178e-01,
+    4.59707615642137690e-01, 4.54696157474615448e-01, 4.49753251162754997e-01,
+    4.44876873414548513e-01, 4.40065100842353896e-01, 4.35316103215636574e-01,
+    4.30628137288458834e-01, 4.25999541143034344e-01, 4.21428728997616575e-01,
+    4.16914186433002876e-01, 4.12454465997161179e-01, 4.08048183152032395e-01,
+    4.03694012530530277e-01, 3.99390684475231073e-01, 3.95136981833290157e-01,
+    3.90931736984797107e-01, 3.86773829084137655e-01, 3.82662181496009834e-01,
+    3.78595759409580790e-01, 3.74573567615902159e-01, 3.70594648435146001e-01,
+    3.66658079781514157e-01, 3.62762973354817775e-01, 3.58908472948749779e-01,
+    3.55093752866787460e-01, 3.51318016437483338e-01, 3.47580494621636982e-01,
+    3.43880444704502408e-01, 3.40217149066780022e-01, 3.36589914028677550e-01,
+    3.32998068761808985e-01, 3.29440964264136327e-01, 3.25917972393556188e-01,
+    3.22428484956089112e-01, 3.18971912844957239e-01, 3.15547685227128949e-01,
+    3.12155248774179550e-01, 3.08794066934560185e-01, 3.05463619244590256e-01,
+    3.02163400675693528e-01, 2.98892921015581792e-01, 2.95651704281261196e-01,
+    2.92439288161892574e-01, 2.89255223489677749e-01, 2.86099073737076826e-01,
+    2.82970414538780746e-01, 2.79868833236972869e-01, 2.76793928448517357e-01,
+    2.73745309652802971e-01, 2.70722596799060022e-01, 2.67725419932044795e-01,
+    2.64753418835062204e-01, 2.61806242689362922e-01, 2.58883549749016229e-01,
+    2.55985007030415379e-01, 2.53110290015629458e-01, 2.50259082368862296e-01,
+    2.47431075665327627e-01, 2.44625969131892107e-01, 2.41843469398877214e-01,
+    2.39083290262449177e-01, 2.36345152457059643e-01, 2.33628783437433346e-01,
+    2.30933917169627412e-01, 2.28260293930716701e-01, 2.25607660116684067e-01,
+    2.22975768058120166e-01, 2.20364375843359495e-01, 2.17773247148700527e-01,
+    2.15202151075378684e-01, 2.12650861992978280e-01, 2.10119159388988258e-01,
+    2.07606827724222037e-01, 2.05113656293837709e-01, 2.02639439093709017e-01,
+    2.00183974691911265e-01, 1.97747066105098873e-01, 1.95328520679563217e-01,
+    1.92928149976771324e-01, 1.90545769663195391e-01, 1.88181199404254290e-01,
+    1.85834262762197111e-01, 1.83504787097767463e-01, 1.81192603475496289e-01,
+    1.78897546572478305e-01, 1.76619454590494884e-01, 1.74358169171353494e-01,
+    1.72113535315320060e-01, 1.69885401302527661e-01, 1.67673618617250192e-01,
+    1.65478041874936005e-01, 1.63298528751901817e-01, 1.61134939917592035e-01,
+    1.58987138969314212e-01, 1.56854992369365231e-01, 1.54738369384468083e-01,
+    1.52637142027442857e-01, 1.50551185001039894e-01, 1.48480375643866791e-01,
+    1.46424593878344944e-01, 1.44383722160634775e-01, 1.42357645432472202e-01,
+    1.40346251074862427e-01, 1.38349428863580204e-01, 1.36367070926428857e-01,
+    1.34399071702213629e-01, 1.32445327901387522e-01, 1.30505738468330773e-01,
+    1.28580204545228172e-01, 1.26668629437510671e-01, 1.24770918580830961e-01,
+    1.22886979509545136e-01, 1.21016721826674833e-01, 1.19160057175327683e-01,
+    1.17316899211555567e-01, 1.15487163578633534e-01, 1.13670767882744314e-01,
+    1.11867631670056297e-01, 1.10077676405185385e-01, 1.08300825451033797e-01,
+    1.06537004050001660e-01, 1.04786139306570172e-01, 1.03048160171257716e-01,
+    1.01322997425953631e-01, 9.96105836706371317e-02, 9.79108533114921992e-02,
+    9.62237425504327976e-02, 9.45491893760558588e-02, 9.28871335560435413e-02,
+    9.12375166310401553e-02, 8.96002819100328585e-02, 8.79753744672702176e-02,
+    8.63627411407569129e-02, 8.47623305323681187e-02, 8.31740930096323827e-02,
+    8.15979807092374193e-02, 8.00339475423199054e-02, 7.84819492016064213e-02,
+    7.69419431704805035e-02, 7.54138887340584096e-02, 7.38977469923647462e-02,
+    7.23934808757087378e-02, 7.09010551623718288e-02, 6.94204364987287548e-02,
+    6.79515934219366013e-02, 6.64944963853397741e-02, 6.50491177867537490e-02,
+    6.36154319998073342e-02, 6.21934154085409946e-02, 6.07830464454796326e-02,
+    5.93843056334202660e-02, 5.79971756312006592e-02, 5.66216412837428767e-02,
+    5.52576896766970374e-02, 5.39053101960460870e-02, 5.25644945930716923e-02,
+    5.12352370551262815e-02, 4.99175342827063717e-02, 4.86113855733794967e-02,
+    4.73167929131815476e-02, 4.60337610761751698e-02, 4.47622977329432820e-02,
+    4.35024135688881833e-02, 4.22541224133162335e-02, 4.10174413804148194e-02,
+    3.97923910233741254e-02, 3.85789955030748574e-02, 3.73772827729593610e-02,
+    3.61872847819314225e-02, 3.50090376973974104e-02, 3.38425821508743299e-02,
+    3.26879635089595347e-02, 3.15452321728936086e-02, 3.04144439104666042e-02,
+    2.92956602246373932e-02, 2.81889487639786357e-02, 2.70943837809557997e-02,
+    2.60120466451342174e-02, 2.49420264197317831e-02, 2.38844205115581708e-02,
+    2.28393354063852402e-02, 2.18068875042835807e-02, 2.07872040725781172e-02,
+    1.97804243380097430e-02, 1.87867007446960305e-02, 1.78062004109113617e-02,
+    1.68391068260399478e-02, 1.58856218399731630e-02, 1.49459680116911485e-02,
+    1.40203914031819376e-02, 1.31091649312549911e-02, 1.22125924262553812e-02,
+    1.13310135978345970e-02, 1.04648101810299789e-02, 9.61441364250220989e-03,
+    8.78031498580897525e-03, 7.96307743801704000e-03, 7.16335318363498386e-03,
+    6.38190593731917909e-03, 5.61964220720548302e-03, 4.87765598354239233e-03,
+    4.15729512083379531e-03, 3.46026477783690405e-03, 2.78879879357407613e-03,
+    2.14596774371890626e-03, 1.53629978030157236e-03, 9.67269282327174536e-04,
+    4.54134353841496765e-04
+};
+
+/* ===========
+ * WORD SOURCE
+   =========== */
+/**
+ * source of 32-bit words for the slow paths. The bulk functions read
+ * the rest of their buffer first, and then xsadd, which is already
+ * advanced to the end of the buffer, so that the sequence is the same
+ * as the one of the single value functions.
+ */
+typedef struct {
+    xsadd_t * xsadd;
+    const uint32_t * buf;
+    size_t pos;
+    size_t size;
+} word_source_t;
+
+static uint32_t next_word(word_source_t * src)
+{
+    if (src->pos < src->size) {
+	return src->buf[src->pos++];
+    }
+    return xsadd_uint32(src->xsadd);
+}
+
+/**
+ * 64-bit unsigned integer from two words, the first one in the lower
+ * bits, so that the buffer can be read as 64-bit integers.
+ */
+static uint64_t next_uint64(word_source_t * src)
+{
+    uint64_t lo = next_word(src);
+    uint64_t hi = next_word(src);
+    return lo | (hi << 32);
+}
+
+/**
+ * double in the range [0, 1), the same as xsadd_double().
+ */
+static double next_double(word_source_t * src)
+{
+    uint64_t a = next_word(src);
+    uint64_t b = next_word(src);
+    return ((a << 21) | (b >> 11)) * DOUBLE_MUL;
+}
+
+/* ===================
+ * ZIGGURAT SLOW PATHS
+   =================== */
+/**
+ * x, which is not negative, with the sign given by bit 8 of r.
+ * This is done without branch, because the sign is random and would
+ * be mispredicted half the time.
+ */
+static inline double with_sign(double x, uint64_t r)
+{
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    u |= (r & 0x100) << 55;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+/**
+ * normal variate from the try r and following words of src.
+ * Bits 0-7 of r are the layer, bit 8 is the sign and bits 9-60 are
+ * the abscissa.
+ */
+static double normal_from(word_source_t * src, uint64_t r)
+{
+    for (;;) {
+	int idx = (int)(r & 0xff);
+	uint64_t rabs = (r >> 9) & ABS_MASK;
+	double x = with_sign(rabs * normal_w[idx], r);
+	if (rabs < normal_k[idx]) {
+	    return x;
+	}
+	if (idx == 0) {
+	    /* tail, by Marsaglia's method */
+	    double xx;
+	    double yy;
+	    do {
+		xx = -NORMAL_R_INV * log1p(-next_double(src));
+		yy = -log1p(-next_double(src));
+	    } while (yy + yy <= xx * xx);
+	    return with_sign(NORMAL_R + xx, r);
+	}
+	if ((normal_f[idx - 1] - normal_f[idx]) * next_double(src)
+	    + normal_f[idx] < exp(-0.5 * x * x)) {
+	    return x;
+	}
+	r = next_uint64(src);
+    }
+}
+
+/**
+ * exponential variate from the try r and following words of src.
+ * Bits 0-7 of r are the layer and bits 12-63 are the abscissa.
+ */
+static double exponential_from(word_source_t * src, uint64_t r)
+{
+    for (;;) {
+	int idx = (int)(r & 0xff);
+	uint64_t rabs = r >> 12;
+	double x = rabs * exp_w[idx];
+	if (rabs < exp_k[idx]) {
+	    return x;
+	}
+	if (idx == 0) {
+	    /* tail, the exponential distribution is memoryless */
+	    return EXP_R - log1p(-next_double(src));
+	}
+	if ((exp_f[idx - 1] - exp_f[idx]) * next_double(src)
+	    + exp_f[idx] < exp(-x)) {
+	    return x;
+	}
+	r = next_uint64(src);
+    }
+}
+
+/* ===================
+ * ZIGGURAT FAST PATHS
+   =================== */
+/**
+ * first tries of normal_from() until the first one which is not
+ * accepted at once.
+ * @param dest normal variates
+ * @param src 32-bit unsigned integers, two for each try
+ * @param size number of tries
+ * @return index of the first try not accepted, or size if none.
+ */
+static size_t normal_fast_generic(double dest[], const uint32_t src[],
+				  size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+	uint64_t r = src[2 * i] | ((uint64_t)src[2 * i + 1] << 32);
+	int idx = (int)(r & 0xff);
+	uint64_t rabs = (r >> 9) & ABS_MASK;
+	if (rabs >= normal_k[idx]) {
+	    return i;
+	}
+	dest[i] = with_sign(rabs * normal_w[idx], r);
+    }
+    return size;
+}
+
+/**
+ * first tries of exponential_from(), see normal_fast_generic().
+ */
+static size_t exponential_fast_generic(double dest[], const uint32_t src[],
+				       size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+	uint64_t r = src[2 * i] | ((uint64_t)src[2 * i + 1] << 32);
+	int idx = (int)(r & 0xff);
+	uint64_t rabs = r >> 12;
+	if (rabs >= exp_k[idx]) {
+	    return i;
+	}
+	dest[i] = rabs * exp_w[idx];
+    }
+    return size;
+}
+
+#if defined(XSADD_X86_KERNELS)
+/**
+ * conversion of 64-bit integers less than 2^52 to double, by putting
+ * them in the mantissa of 2^52.
+ */
+__attribute__((target("avx2")))
+static inline __m256d u52_to_double_avx2(__m256i x)
+{
+    const __m256i exp52 = _mm256_set1_epi64x(INT64_C(0x4330000000000000));
+    return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(x, exp52)),
+			 _mm256_set1_pd(4503599627370496.0));
+}
+
+/**
+ * normal_fast_generic() for four tries at once, the table entries
+ * are loaded by gather. Four variates are stored only if all of them
+ * are accepted, otherwise the index of the group is returned.
+ */
+__attribute__((target("avx2")))
+static size_t normal_fast_avx2(double dest[], const uint32_t src[],
+			       size_t size)
+{
+    const __m256i idx_mask = _mm256_set1_epi64x(0xff);
+    const __m256i abs_mask = _mm256_set1_epi64x((int64_t)ABS_MASK);
+    const __m256i sign_mask = _mm256_set1_epi64x(INT64_C(1) << 63);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+	__m256i r = _mm256_loadu_si256((const __m256i *)&src[2 * i]);
+	__m256i idx = _mm256_and_si256(r, idx_mask);
+	__m256i rabs = _mm256_and_si256(_mm256_srli_epi64(r, 9), abs_mask);
+	__m256i k = _mm256_i64gather_epi64((const long long *)normal_k,
+					   idx, 8);
+	__m256i ok = _mm256_cmpgt_epi64(k, rabs);
+	if (_mm256_movemask_pd(_mm256_castsi256_pd(ok)) != 0xf) {
+	    return i;
+	}
+	__m256d x = _mm256_mul_pd(u52_to_double_avx2(rabs),
+				  _mm256_i64gather_pd(normal_w, idx, 8));
+	__m256i sign = _mm256_and_si256(_mm256_slli_epi64(r, 55),
+					sign_mask);
+	x = _mm256_xor_pd(x, _mm256_castsi256_pd(sign));
+	_mm256_storeu_pd(&dest[i], x);
+    }
+    /* gcc does not always clear the upper halves before this call,
+       which makes SSE code of libm very slow afterwards */
+    _mm256_zeroupper();
+    return i + normal_fast_generic(&dest[i], &src[2 * i], size - i);
+}
+
+/**
+ * exponential_fast_generic() for four tries at once, see
+ * normal_fast_avx2().
+ */
+__attribute__((target("avx2")))
+static size_t exponential_fast_avx2(double dest[], const uint32_t src[],
+				    size_t size)
+{
+    const __m256i idx_mask = _mm256_set1_epi64x(0xff);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+	__m256i r = _mm256_loadu_si256((const __m256i *)&src[2 * i]);
+	__m256i idx = _mm256_and_si256(r, idx_mask);
+	__m256i rabs = _mm256_srli_epi64(r, 12);
+	__m256i k = _mm256_i64gather_epi64((const long long *)exp_k,
+					   idx, 8);
+	__m256i ok = _mm256_cmpgt_epi64(k, rabs);
+	if (_mm256_movemask_pd(_mm256_castsi256_pd(ok)) != 0xf) {
+	    return i;
+	}
+	__m256d x = _mm256_mul_pd(u52_to_double_avx2(rabs),
+				  _mm256_i64gather_pd(exp_w, idx, 8));
+	_mm256_storeu_pd(&dest[i], x);
+    }
+    _mm256_zeroupper();
+    return i + exponential_fast_generic(&dest[i], &src[2 * i], size - i);
+}
+#endif
+
+typedef size_t (*fast_path_t)(double dest[], const uint32_t src[],
+			      size_t size);
+typedef double (*slow_path_t)(word_source_t * src, uint64_t r);
+
+/**
+ * use the avx2 fast paths if bulk generation of xsadd.c uses avx2 or
+ * wider kernel, so that XSADD_KERNEL and xsadd_set_kernel() also
+ * select the kernel of this file.
+ */
+static int use_avx2(void)
+{
+#if defined(XSADD_X86_KERNELS)
+    const char * name = xsadd_kernel_name();
+    return strcmp(name, "avx2") == 0 || strcmp(name, "avx512") == 0;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * fill array by the ziggurat method.
+ * Words are generated into the buffer, the fast path converts the
+ * tries accepted at once, and each try it stops at is completed by
+ * the slow path reading the following words.
+ * Every variate uses at least two words and the buffer is at most
+ * twice of the rest of the array, so the buffer is always used up
+ * before the array is filled.
+ * @param xsadd xsadd internal state
+ * @param array the array to be filled
+ * @param size number of elements of the array
+ * @param fast fast path
+ * @param slow slow path
+ */
+static void fill_ziggurat(xsadd_t * xsadd, double array[], size_t size,
+			  fast_path_t fast, slow_path_t slow)
+{
+    uint32_t buf[DIST_BUFFER_SIZE];
+    size_t i = 0;
+    while (i < size) {
+	word_source_t src;
+	size_t m = size - i;
+	if (m > DIST_BUFFER_SIZE / 2) {
+	    m = DIST_BUFFER_SIZE / 2;
+	}
+	xsadd_fill_array_uint32(xsadd, buf, 2 * m);
+	src.xsadd = xsadd;
+	src.buf = buf;
+	src.pos = 0;
+	src.size = 2 * m;
+	while (src.pos < src.size) {
+	    size_t count = (src.size - src.pos) / 2;
+	    size_t len = fast(&array[i], &buf[src.pos], count);
+	    i += len;
+	    src.pos += 2 * len;
+	    if (len < count) {
+		uint64_t r = next_uint64(&src);
+		array[i] = slow(&src, r);
+		i++;
+	    }
+	}
+    }
+}
+
+/* ===============
+ * BOUNDED INDICES
+   =============== */
+/**
+ * 64 x 64 to 128-bit multiplication.
+ * @param lo lower 64 bits of the product
+ * @param a multiplicand
+ * @param b multiplier
+ * @return higher 64 bits of the product
+ */
+static inline uint64_t mul128(uint64_t * lo, uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 m = (unsigned __int128)a * b;
+    *lo = (uint64_t)m;
+    return (uint64_t)(m >> 64);
+#else
+    uint64_t a0 = (uint32_t)a;
+    uint64_t a1 = a >> 32;
+    uint64_t b0 = (uint32_t)b;
+    uint64_t b1 = b >> 32;
+    uint64_t p00 = a0 * b0;
+    uint64_t p01 = a0 * b1;
+    uint64_t p10 = a1 * b0;
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    *lo = (mid << 32) | (uint32_t)p00;
+    return a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+/**
+ * unbiased 64-bit integer in the range [0, n), by the method of
+ * xsadd_uint32_bounded() extended to 64 bits.
+ */
+static uint64_t bounded64(word_source_t * src, uint64_t n)
+{
+    uint64_t lo;
+    uint64_t r = mul128(&lo, next_uint64(src), n);
+    if (lo < n) {
+	uint64_t t = (0 - n) % n;
+	while (lo < t) {
+	    r = mul128(&lo, next_uint64(src), n);
+	}
+    }
+    return r;
+}
+
+/**
+ * one try of two integers in the ranges [0, n1) and [0, n2) from one
+ * 64-bit output u, by the batched method of Brackett-Rozinsky and
+ * Lemire. u is multiplied by n1, and the lower half of the product by
+ * n2, and the higher halves are the results. The try is rejected only
+ * if the last lower half is less than 2<sup>64</sup> % (n1 n2), and
+ * the division is done only if it is less than n1 n2, which is rare.
+ * n1 n2 must not exceed 2<sup>64</sup>.
+ * @return 1 if rejected, 0 otherwise.
+ */
+static inline int pair_rejected(uint64_t u, uint64_t n1, uint64_t n2,
+				uint64_t * r1, uint64_t * r2)
+{
+    uint64_t bound = n1 * n2;
+    uint64_t lo;
+    *r1 = mul128(&lo, u, n1);
+    *r2 = mul128(&lo, lo, n2);
+    return lo < bound && lo < (0 - bound) % bound;
+}
+
+/**
+ * pair_rejected() with 32-bit output u. n1 n2 must not exceed
+ * 2<sup>32</sup>, then the two indices cost one output of xsadd.
+ */
+static inline int pair32_rejected(uint32_t u, uint32_t n1, uint32_t n2,
+				  uint64_t * r1, uint64_t * r2)
+{
+    uint64_t bound = (uint64_t)n1 * n2;
+    uint64_t m = (uint64_t)u * n1;
+    *r1 = m >> 32;
+    m = (m & 0xffffffff) * n2;
+    *r2 = m >> 32;
+    m &= 0xffffffff;
+    return m < bound && m < (RANGE32 - bound) % bound;
+}
+
+/**
+ * 64-bit output of xsadd, the same as next_uint64(). This is used in
+ * loops where the state is kept in a local variable, which is faster
+ * than going through word_source_t.
+ */
+static inline uint64_t local_uint64(xsadd_t * xsadd)
+{
+    uint64_t lo = xsadd_uint32(xsadd);
+    uint64_t hi = xsadd_uint32(xsadd);
+    return lo | (hi << 32);
+}
+
+/**
+ * the last index of odd count, the same as xsadd_uint32_bounded().
+ * n may be 2<sup>32</sup>.
+ */
+static uint64_t bounded_last(word_source_t * src, uint64_t n)
+{
+    uint64_t m = (uint64_t)next_word(src) * n;
+    if ((uint32_t)m < n) {
+	uint32_t t = (uint32_t)((RANGE32 - n) % n);
+	while ((uint32_t)m < t) {
+	    m = (uint64_t)next_word(src) * n;
+	}
+    }
+    return m >> 32;
+}
+
+/**
+ * Fisher-Yates steps from m elements down to m - count elements with
+ * the indices computed in a batch.
+ * The words are generated into buf by xsadd_fill_array_uint32(), which
+ * uses the vector kernel for large buf, and changed into indices in
+ * place. Rejections read ahead, and the words after buf are read
+ * from xsadd. Then the swaps are done prefetching the elements.
+ * count must be even, and the ranges must be in (PAIR32_MAX,
+ * 2<sup>32</sup>].
+ */
+static void shuffle_batch(xsadd_t * xsadd, uint32_t array[], uint64_t m,
+			  uint32_t buf[], size_t count)
+{
+    word_source_t src;
+    uint64_t n = m;
+    src.xsadd = xsadd;
+    src.buf = buf;
+    src.pos = 0;
+    src.size = count;
+    xsadd_fill_array_uint32(xsadd, buf, count);
+    for (size_t i = 0; i < count; i += 2) {
+	uint64_t r1;
+	uint64_t r2;
+	while (pair_rejected(next_uint64(&src), n, n - 1, &r1, &r2)) {
+	}
+	buf[i] = (uint32_t)r1;
+	buf[i + 1] = (uint32_t)r2;
+	n -= 2;
+    }
+    for (size_t i = 0; i < count; i++) {
+#if defined(__GNUC__)
+	if (i + SHUFFLE_PREFETCH_DISTANCE < count) {
+	    __builtin_prefetch(&array[buf[i + SHUFFLE_PREFETCH_DISTANCE]], 1);
+	}
+#endif
+	uint32_t j = buf[i];
+	uint32_t tmp = array[m - 1 - i];
+	array[m - 1 - i] = array[j];
+	array[j] = tmp;
+    }
+}
+
+/* ================
+ * PUBLIC FUNCTIONS
+   ================ */
+double xsadd_normal(xsadd_t * xsadd)
+{
+    uint32_t w[2];
+    double x;
+    w[0] = xsadd_uint32(xsadd);
+    w[1] = xsadd_uint32(xsadd);
+    if (normal_fast_generic(&x, w, 1) == 1) {
+	return x;
+    }
+    word_source_t src = {xsadd, w, 0, 2};
+    return normal_from(&src, next_uint64(&src));
+}
+
+double xsadd_exponential(xsadd_t * xsadd)
+{
+    uint32_t w[2];
+    double x;
+    w[0] = xsadd_uint32(xsadd);
+    w[1] = xsadd_uint32(xsadd);
+    if (exponential_fast_generic(&x, w, 1) == 1) {
+	return x;
+    }
+    word_source_t src = {xsadd, w, 0, 2};
+    return exponential_from(&src, next_uint64(&src));
+}
+
+void xsadd_fill_array_normal(xsadd_t * xsadd, double array[], size_t size)
+{
+#if defined(XSADD_X86_KERNELS)
+    if (use_avx2()) {
+	fill_ziggurat(xsadd, array, size, normal_fast_avx2, normal_from);
+	return;
+    }
+#endif
+    fill_ziggurat(xsadd, array, size, normal_fast_generic, normal_from);
+}
+
+void xsadd_fill_array_exponential(xsadd_t * xsadd, double array[],
+				  size_t size)
+{
+#if defined(XSADD_X86_KERNELS)
+    if (use_avx2()) {
+	fill_ziggurat(xsadd, array, size, exponential_fast_avx2,
+		      exponential_from);
+	return;
+    }
+#endif
+    fill_ziggurat(xsadd, array, size, exponential_fast_generic,
+		  exponential_from);
+}
+
+int xsadd_alias_init(xsadd_alias_t * alias, const double weights[],
+		     uint32_t n)
+{
+    double sum = 0;
+    if (n == 0) {
+	return -1;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+	if (!(weights[i] >= 0)) {
+	    return -1;
+	}
+	sum += weights[i];
+    }
+    if (!(sum > 0 && sum <= DBL_MAX)) {
+	return -1;
+    }
+    xsadd_alias_entry_t * table
+	= (xsadd_alias_entry_t *)malloc(sizeof(xsadd_alias_entry_t) * n);
+    double * p = (double *)malloc(sizeof(double) * n);
+    uint32_t * work = (uint32_t *)malloc(sizeof(uint32_t) * n);
+    if (table == NULL || p == NULL || work == NULL) {
+	free(table);
+	free(p);
+	free(work);
+	return -1;
+    }
+    /* Vose's method: columns less than 1 are on the stack from the
+       front of work, the others on the stack from the back.
+       n / sum may overflow when sum is subnormal, so divide first. */
+    uint32_t small_end = 0;
+    uint32_t large_begin = n;
+    for (uint32_t i = 0; i < n; i++) {
+	p[i] = weights[i] / sum * n;
+	if (p[i] < 1.0) {
+	    work[small_end++] = i;
+	} else {
+	    work[--large_begin] = i;
+	}
+    }
+    while (small_end > 0 && large_begin < n) {
+	uint32_t s = work[--small_end];
+	uint32_t l = work[large_begin];
+	double t = floor(p[s] * 4294967296.0 + 0.5);
+	table[s].prob = t < 4294967295.0 ? (uint32_t)t : UINT32_C(0xffffffff);
+	table[s].alias = l;
+	p[l] = (p[l] + p[s]) - 1.0;
+	if (p[l] < 1.0) {
+	    large_begin++;
+	    work[small_end++] = l;
+	}
+    }
+    /* the rest are 1 except for rounding errors */
+    while (small_end > 0) {
+	uint32_t s = work[--small_end];
+	table[s].prob = UINT32_C(0xffffffff);
+	table[s].alias = s;
+    }
+    while (large_begin < n) {
+	uint32_t l = work[large_begin++];
+	table[l].prob = UINT32_C(0xffffffff);
+	table[l].alias = l;
+    }
+    free(p);
+    free(work);
+    alias->size = n;
+    alias->table = table;
+    return 0;
+}
+
+void xsadd_alias_free(xsadd_alias_t * alias)
+{
+    free(alias->table);
+    alias->table = NULL;
+    alias->size = 0;
+}
+
+void xsadd_alias_fill(xsadd_t * xsadd, const xsadd_alias_t * alias,
+		      uint32_t array[], size_t size)
+{
+    const xsadd_alias_entry_t * table = alias->table;
+    const uint64_t n = alias->size;
+    for (size_t start = 0; start < size; start += ALIAS_CHUNK_SIZE) {
+	size_t len = size - start;
+	if (len > ALIAS_CHUNK_SIZE) {
+	    len = ALIAS_CHUNK_SIZE;
+	}
+	uint32_t * a = &array[start];
+	xsadd_fill_array_uint32(xsadd, a, len);
+	for (size_t i = 0; i < len; i++) {
+#if defined(__GNUC__)
+	    if (i + ALIAS_PREFETCH_DISTANCE < len) {
+		__builtin_prefetch(
+		    &table[(a[i + ALIAS_PREFETCH_DISTANCE] * n) >> 32]);
+	    }
+#endif
+	    uint64_t m = a[i] * n;
+	    uint32_t k = (uint32_t)(m >> 32);
+	    xsadd_alias_entry_t e = table[k];
+	    uint32_t mask = 0 - (uint32_t)((uint32_t)m < e.prob);
+	    a[i] = (k & mask) | (e.alias & ~mask);
+	}
+    }
+}
+
+void xsadd_shuffle(xsadd_t * xsadd, uint32_t array[], size_t size)
+{
+    uint64_t m = size;
+    /* ranges over 2^32 are possible only for huge arrays */
+    while (m > RANGE32) {
+	word_source_t src = {xsadd, NULL, 0, 0};
+	uint64_t j = bounded64(&src, m);
+	uint32_t tmp = array[m - 1];
+	array[m - 1] = array[j];
+	array[j] = tmp;
+	m--;
+    }
+    /* batches are used down to PAIR32_MAX */
+    if (m > SHUFFLE_BATCH_SIZE + PAIR32_MAX) {
+	uint32_t * buf = (uint32_t *)malloc(sizeof(uint32_t)
+					   * SHUFFLE_BATCH_SIZE);
+	if (buf != NULL) {
+	    while (m > SHUFFLE_BATCH_SIZE + PAIR32_MAX) {
+		shuffle_batch(xsadd, array, m, buf, SHUFFLE_BATCH_SIZE);
+		m -= SHUFFLE_BATCH_SIZE;
+	    }
+	    free(buf);
+	}
+    }
+    /* the rest is small enough to be in cache */
+    xsadd_t xs = *xsadd;
+    for (; m > 2; m -= 2) {
+	uint64_t r1;
+	uint64_t r2;
+	if (m <= PAIR32_MAX) {
+	    while (pair32_rejected(xsadd_uint32(&xs), (uint32_t)m,
+				   (uint32_t)m - 1, &r1, &r2)) {
+	    }
+	} else {
+	    while (pair_rejected(local_uint64(&xs), m, m - 1, &r1, &r2)) {
+	    }
+	}
+	uint32_t tmp = array[m - 1];
+	array[m - 1] = array[r1];
+	array[r1] = tmp;
+	tmp = array[m - 2];
+	array[m - 2] = array[r2];
+	array[r2] = tmp;
+    }
+    if (m == 2) {
+	word_source_t src = {&xs, NULL, 0, 0};
+	uint64_t j = bounded_last(&src, 2);
+	uint32_t tmp = array[1];
+	array[1] = array[j];
+	array[j] = tmp;
+    }
+    *xsadd = xs;
+}
+
+size_t xsadd_reservoir_sample(xsadd_t * xsadd, uint32_t sample[], size_t k,
+			      const uint32_t population[], size_t n)
+{
+    uint64_t i = k < n ? k : n;
+    if (i > 0) {
+	memcpy(sample, population, sizeof(uint32_t) * i);
+    }
+    xsadd_t xs = *xsadd;
+    for (; i + 2 <= n && i + 2 <= RANGE32; i += 2) {
+	uint64_t r1;
+	uint64_t r2;
+	if (i + 2 <= PAIR32_MAX) {
+	    while (pair32_rejected(xsadd_uint32(&xs), (uint32_t)i + 1,
+				   (uint32_t)i + 2, &r1, &r2)) {
+	    }
+	} else {
+	    while (pair_rejected(local_uint64(&xs), i + 1, i + 2, &r1, &r2)) {
+	    }
+	}
+	if (r1 < k) {
+	    sample[r1] = population[i];
+	}
+	if (r2 < k) {
+	    sample[r2] = population[i + 1];
+	}
+    }
+    word_source_t src = {&xs, NULL, 0, 0};
+    if (i + 1 == n && i + 1 <= RANGE32) {
+	uint64_t j = bounded_last(&src, i + 1);
+	if (j < k) {
+	    sample[j] = population[i];
+	}
+	i++;
+    }
+    /* ranges over 2^32 */
+    for (; i < n; i++) {
+	uint64_t j = bounded64(&src, i + 1);
+	if (j < k) {
+	    sample[j] = population[i];
+	}
+    }
+    *xsadd = xs;
+    return k < n ? k : n;
+}
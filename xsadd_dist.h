@@ -0,0 +1,213 @@
+#ifndef XSADD_DIST_H
+#define XSADD_DIST_H
+/**
+ * @file xsadd_dist.h
+ *
+ * @brief XORSHIFT-ADD: non-uniform distributions.
+ *
+ * These functions are separated from xsadd.h because they need the
+ * math library. Link with -lm.
+ *
+ * @author Mutsuo Saito (Manieth Corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (c) 2014
+ * Mutsuo Saito, Makoto Matsumoto, Hiroshima University
+ * and Manieth Corp.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xsadd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /* ===============================
+     * normal and exponential variates
+     * =============================== */
+    /**
+     * This function outputs a standard normal variate by the ziggurat
+     * method of G. Marsaglia and W. W. Tsang with 256 layers.
+     * Each try uses two outputs of xsadd_uint32(), 8 bits for the
+     * layer, 1 bit for the sign and 52 bits for the abscissa, and is
+     * accepted without evaluating exp() with probability about 0.99.
+     * @param[in,out] xsadd xsadd internal state
+     * @return normal variate with mean 0 and standard deviation 1.
+     */
+    double xsadd_normal(xsadd_t * xsadd);
+
+    /**
+     * This function outputs a standard exponential variate by the
+     * ziggurat method with 256 layers, like xsadd_normal().
+     * @param[in,out] xsadd xsadd internal state
+     * @return exponential variate with mean 1.
+     */
+    double xsadd_exponential(xsadd_t * xsadd);
+
+    /**
+     * This function fills an array with standard normal variates.
+     * The array is filled with the same sequence as calling
+     * xsadd_normal() \b size times. The outputs of xsadd are
+     * generated by xsadd_fill_array_uint32(), the tries accepted at
+     * the first step are converted by the vector kernel, and the
+     * others are handled out of the vector loop.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_normal(xsadd_t * xsadd, double array[],
+				 size_t size);
+
+    /**
+     * This function fills an array with standard exponential
+     * variates. The array is filled with the same sequence as calling
+     * xsadd_exponential() \b size times, see
+     * xsadd_fill_array_normal().
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_fill_array_exponential(xsadd_t * xsadd, double array[],
+				      size_t size);
+
+    /* ============
+     * alias method
+     * ============ */
+    /**
+     * one column of the alias table.
+     * The column i gives i if the threshold is less than \b prob,
+     * otherwise \b alias. Both are in one struct, so that a sample
+     * reads one 8-byte entry.
+     */
+    typedef struct {
+	uint32_t prob;
+	uint32_t alias;
+    } xsadd_alias_entry_t;
+
+    /**
+     * alias table of a discrete distribution of \b size categories.
+     */
+    typedef struct {
+	uint32_t size;
+	xsadd_alias_entry_t * table;
+    } xsadd_alias_t;
+
+    /**
+     * This function makes the alias table of the discrete
+     * distribution given by weights, by Vose's method in O(n) time.
+     * The table is allocated by malloc() and should be released by
+     * xsadd_alias_free(). Probabilities are rounded to multiples of
+     * 2<sup>-32</sup> in each column, and sampling adds an error of
+     * about n * 2<sup>-32</sup>, see xsadd_alias_sample().
+     * @param[out] alias alias table
+     * @param[in] weights non-negative weights of categories, which
+     * need not be normalized.
+     * @param[in] n number of categories, 0 < n
+     * @return 0 if success, -1 if n is 0, a weight is negative or not
+     * a number, the sum of weights is not positive and finite, or
+     * memory can not be allocated.
+     */
+    int xsadd_alias_init(xsadd_alias_t * alias, const double weights[],
+			 uint32_t n);
+
+    /**
+     * This function releases the table made by xsadd_alias_init().
+     * @param[in,out] alias alias table
+     */
+    void xsadd_alias_free(xsadd_alias_t * alias);
+
+    /**
+     * This function outputs a category of the alias table using one
+     * output of xsadd_uint32(). The high 32 bits of the product of
+     * the output and n is the column, and the low 32 bits are the
+     * threshold compared with the probability of the column.
+     * The selection is done without branch, which would be
+     * mispredicted often.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[in] alias alias table
+     * @return category r (0 <= r < n)
+     */
+    static inline uint32_t xsadd_alias_sample(xsadd_t * xsadd,
+					      const xsadd_alias_t * alias)
+    {
+	uint64_t m = (uint64_t)xsadd_uint32(xsadd) * alias->size;
+	uint32_t i = (uint32_t)(m >> 32);
+	xsadd_alias_entry_t e = alias->table[i];
+	uint32_t mask = 0 - (uint32_t)((uint32_t)m < e.prob);
+	return (i & mask) | (e.alias & ~mask);
+    }
+
+    /**
+     * This function fills an array with categories of the alias
+     * table. The array is filled with the same sequence as calling
+     * xsadd_alias_sample() \b size times. The outputs are generated
+     * by xsadd_fill_array_uint32() into the array, and the table
+     * entries are prefetched ahead of their use.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[in] alias alias table
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_alias_fill(xsadd_t * xsadd, const xsadd_alias_t * alias,
+			  uint32_t array[], size_t size);
+
+    /* ====================
+     * shuffle and sampling
+     * ==================== */
+    /**
+     * This function shuffles an array uniformly by the Fisher-Yates
+     * method. Two indices of consecutive steps are made from one
+     * 64-bit output, two outputs of xsadd_uint32(), by multiplying it
+     * by the two ranges in turn, which is unbiased and seldom
+     * rejected. If the ranges are 2<sup>16</sup> or less, they are
+     * made from one output of xsadd_uint32(). For large arrays, the
+     * outputs are generated by xsadd_fill_array_uint32() for a batch
+     * of steps, and the elements to be swapped are prefetched.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[in,out] array the array to be shuffled
+     * @param[in] size number of elements of the array
+     */
+    void xsadd_shuffle(xsadd_t * xsadd, uint32_t array[], size_t size);
+
+    /**
+     * This function selects \b k elements of \b population uniformly
+     * without replacement by reservoir sampling (algorithm R of
+     * Vitter). The random indices are made two from one output, like
+     * xsadd_shuffle(). The order of the sample is not random.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] sample array of \b k elements, the selected elements.
+     * @param[in] k number of elements to be selected.
+     * @param[in] population array of \b n elements.
+     * @param[in] n number of elements of population.
+     * @return number of selected elements, the smaller of \b k and
+     * \b n.
+     */
+    size_t xsadd_reservoir_sample(xsadd_t * xsadd, uint32_t sample[],
+				  size_t k, const uint32_t population[],
+				  size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // XSADD_DIST_H
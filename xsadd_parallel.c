@@ -0,0 +1,312 @@
+/**
+ * @file xsadd_parallel.c
+ *
+ * @brief XORSHIFT-ADD: multi-threaded helpers using POSIX threads.
+ *
+ * @author Mutsuo Saito (Manieth Corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (c) 2014
+ * Mutsuo Saito, Makoto Matsumoto, Manieth Corp.,
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <xsadd_parallel.h>
+#include <pthread.h>
+
+/*
+ * maximum number of threads.
+ */
+#define MAX_THREADS 256
+
+/*
+ * minimum number of elements filled by one thread of
+ * xsadd_parallel_fill. Smaller blocks do not pay for the thread and
+ * the jump.
+ */
+#define FILL_MIN_BLOCK (1024 * 1024)
+
+/*
+ * seed of the root stream of xsadd_thread_local().
+ */
+#define THREAD_LOCAL_SEED 1234
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define THREAD_LOCAL _Thread_local
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+/**
+ * work of one thread of xsadd_spawn_streams_parallel.
+ */
+struct SPAWN_WORK_T {
+    const xsadd_t * root;
+    xsadd_t * out;
+    size_t start;
+    size_t size;
+    const xsadd_jump_poly_t * jump_poly;
+};
+
+typedef struct SPAWN_WORK_T spawn_work;
+
+/**
+ * work of one thread of xsadd_parallel_fill.
+ */
+struct FILL_WORK_T {
+    xsadd_t xsadd;
+    uint32_t * array;
+    size_t start;
+    size_t size;
+};
+
+typedef struct FILL_WORK_T fill_work;
+
+static void * spawn_thread(void * arg);
+static void * fill_thread(void * arg);
+static void thread_local_setup(uint32_t seed);
+static void thread_local_assign(void);
+
+/*
+ * root stream and jump polynomial of xsadd_thread_local(), set once
+ * under the lock. tl_initialized is read without the lock.
+ */
+static pthread_mutex_t tl_lock = PTHREAD_MUTEX_INITIALIZER;
+static int tl_initialized = 0;
+static xsadd_t tl_root;
+static xsadd_jump_poly_t tl_poly;
+/*
+ * index of the next stream.
+ */
+static uint64_t tl_next = 0;
+/*
+ * stream of each thread.
+ */
+static THREAD_LOCAL xsadd_t tl_state;
+static THREAD_LOCAL uint64_t tl_index;
+static THREAD_LOCAL int tl_ready = 0;
+
+/* ================
+ * PUBLIC FUNCTIONS
+   ================ */
+void xsadd_spawn_streams_parallel(const xsadd_t * root, xsadd_t out[],
+				  size_t n,
+				  uint64_t step_hi, uint64_t step_lo,
+				  int nthreads)
+{
+    xsadd_jump_poly_t jump_poly;
+    spawn_work work[MAX_THREADS];
+    pthread_t thread[MAX_THREADS];
+    int created[MAX_THREADS];
+    if (n == 0) {
+	return;
+    }
+    if (nthreads < 1) {
+	nthreads = 1;
+    }
+    if ((size_t)nthreads > n) {
+	nthreads = (int)n;
+    }
+    if (nthreads > MAX_THREADS) {
+	nthreads = MAX_THREADS;
+    }
+    xsadd_calculate_jump_poly_u128(&jump_poly, step_hi, step_lo);
+    if (nthreads <= 1) {
+	xsadd_spawn_streams_by_poly(root, out, n, &jump_poly);
+	return;
+    }
+    size_t chunk = (n + nthreads - 1) / nthreads;
+    for (int k = 0; k < nthreads; k++) {
+	work[k].root = root;
+	work[k].out = out;
+	work[k].start = chunk * k;
+	work[k].size = 0;
+	if (work[k].start < n) {
+	    work[k].size = n - work[k].start < chunk
+		? n - work[k].start : chunk;
+	}
+	work[k].jump_poly = &jump_poly;
+	created[k] = 0;
+    }
+    for (int k = 1; k < nthreads; k++) {
+	if (work[k].size > 0) {
+	    created[k] = pthread_create(&thread[k], NULL, spawn_thread,
+					&work[k]) == 0;
+	}
+    }
+    spawn_thread(&work[0]);
+    for (int k = 1; k < nthreads; k++) {
+	if (created[k]) {
+	    pthread_join(thread[k], NULL);
+	} else if (work[k].size > 0) {
+	    spawn_thread(&work[k]);
+	}
+    }
+}
+
+void xsadd_parallel_fill(xsadd_t * xsadd, uint32_t array[], size_t size,
+			 int nthreads)
+{
+    fill_work work[MAX_THREADS];
+    pthread_t thread[MAX_THREADS];
+    int created[MAX_THREADS];
+    if (nthreads < 1) {
+	nthreads = 1;
+    }
+    if ((size_t)nthreads > size / FILL_MIN_BLOCK) {
+	nthreads = (int)(size / FILL_MIN_BLOCK);
+    }
+    if (nthreads > MAX_THREADS) {
+	nthreads = MAX_THREADS;
+    }
+    if (nthreads <= 1) {
+	xsadd_fill_array_uint32(xsadd, array, size);
+	return;
+    }
+    size_t chunk = (size + nthreads - 1) / nthreads;
+    for (int k = 0; k < nthreads; k++) {
+	work[k].xsadd = *xsadd;
+	work[k].array = array;
+	work[k].start = chunk * k;
+	work[k].size = size - work[k].start < chunk
+	    ? size - work[k].start : chunk;
+	created[k] = 0;
+    }
+    for (int k = 1; k < nthreads; k++) {
+	created[k] = pthread_create(&thread[k], NULL, fill_thread,
+				    &work[k]) == 0;
+    }
+    fill_thread(&work[0]);
+    for (int k = 1; k < nthreads; k++) {
+	if (created[k]) {
+	    pthread_join(thread[k], NULL);
+	} else {
+	    fill_thread(&work[k]);
+	}
+    }
+    /* the last block ends at size */
+    *xsadd = work[nthreads - 1].xsadd;
+}
+
+int xsadd_thread_local_seed(uint32_t seed)
+{
+    int result = -1;
+    pthread_mutex_lock(&tl_lock);
+    if (!tl_initialized) {
+	thread_local_setup(seed);
+	result = 0;
+    }
+    pthread_mutex_unlock(&tl_lock);
+    return result;
+}
+
+xsadd_t * xsadd_thread_local(void)
+{
+    if (!tl_ready) {
+	thread_local_assign();
+    }
+    return &tl_state;
+}
+
+uint64_t xsadd_thread_local_index(void)
+{
+    if (!tl_ready) {
+	thread_local_assign();
+    }
+    return tl_index;
+}
+
+/* ================
+ * PRIVATE FUNCTIONS
+   ================ */
+/**
+ * make out[start], ..., out[start + size - 1].
+ * out[start] is made by the jump polynomial to the power of start.
+ * @param arg pointer to spawn_work
+ * @return NULL
+ */
+static void * spawn_thread(void * arg)
+{
+    spawn_work * work = (spawn_work *)arg;
+    xsadd_t first = *work->root;
+    if (work->start > 0) {
+	xsadd_jump_poly_t start_poly;
+	xsadd_jump_poly_pow(&start_poly, work->jump_poly, work->start);
+	xsadd_jump_by_poly(&first, &start_poly);
+    }
+    xsadd_spawn_streams_by_poly(&first, &work->out[work->start], work->size,
+				work->jump_poly);
+    return NULL;
+}
+
+/**
+ * fill array[start], ..., array[start + size - 1].
+ * The state is jumped to start, and is left at start + size.
+ * @param arg pointer to fill_work
+ * @return NULL
+ */
+static void * fill_thread(void * arg)
+{
+    fill_work * work = (fill_work *)arg;
+    xsadd_discard(&work->xsadd, work->start);
+    xsadd_fill_array_uint32(&work->xsadd, &work->array[work->start],
+			    work->size);
+    return NULL;
+}
+
+/**
+ * initialize the root stream and the jump polynomial of
+ * xsadd_thread_local(). Called with tl_lock held.
+ * @param seed seed of the root stream
+ */
+static void thread_local_setup(uint32_t seed)
+{
+    xsadd_init(&tl_root, seed);
+    xsadd_calculate_jump_poly(&tl_poly, 1, xsadd_jump_base_step);
+    __atomic_store_n(&tl_initialized, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * assign a stream to the calling thread.
+ * The lock is taken only until the root stream is initialized, and
+ * the index is taken by atomic increment.
+ */
+static void thread_local_assign(void)
+{
+    if (!__atomic_load_n(&tl_initialized, __ATOMIC_ACQUIRE)) {
+	pthread_mutex_lock(&tl_lock);
+	if (!tl_initialized) {
+	    thread_local_setup(THREAD_LOCAL_SEED);
+	}
+	pthread_mutex_unlock(&tl_lock);
+    }
+    uint64_t k = __atomic_fetch_add(&tl_next, 1, __ATOMIC_RELAXED);
+    tl_state = tl_root;
+    if (k > 0) {
+	xsadd_jump_poly_t poly;
+	xsadd_jump_poly_pow(&poly, &tl_poly, k);
+	xsadd_jump_by_poly(&tl_state, &poly);
+    }
+    tl_index = k;
+    tl_ready = 1;
+}
@@ -0,0 +1,122 @@
+#ifndef XSADD_PARALLEL_H
+#define XSADD_PARALLEL_H
+/**
+ * @file xsadd_parallel.h
+ *
+ * @brief XORSHIFT-ADD: multi-threaded helpers using POSIX threads.
+ *
+ * These functions are separated from xsadd.h so that programs which
+ * do not use threads need not link the thread library. Link with
+ * -lpthread.
+ *
+ * @author Mutsuo Saito (Manieth Corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (c) 2014
+ * Mutsuo Saito, Makoto Matsumoto, Hiroshima University
+ * and Manieth Corp.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xsadd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /**
+     * This function makes the same streams as xsadd_spawn_streams(),
+     * using \b nthreads threads. The thread k starts from out[k * m],
+     * where m = ceil(n / nthreads), which is \b root jumped by
+     * k * m * step using the power of the jump polynomial, and
+     * continues the chain of jumps from there.
+     * If a thread can not be created, its part is made by the calling
+     * thread.
+     * @param[in] root xsadd state of the first stream.
+     * @param[out] out array of \b n xsadd states.
+     * @param[in] n number of streams.
+     * @param[in] step_hi upper 64 bits of jump step.
+     * @param[in] step_lo lower 64 bits of jump step.
+     * @param[in] nthreads number of threads, 1 or less means no
+     * thread is created.
+     */
+    void xsadd_spawn_streams_parallel(const xsadd_t * root, xsadd_t out[],
+				      size_t n,
+				      uint64_t step_hi, uint64_t step_lo,
+				      int nthreads);
+
+    /**
+     * This function fills an array with 32-bit unsigned integers using
+     * \b nthreads threads. The array is filled with the same sequence
+     * as calling xsadd_uint32() \b size times, independently of
+     * \b nthreads, and \b xsadd is advanced by \b size. The thread k
+     * fills the k-th block of the array from a copy of \b xsadd jumped
+     * to the start of the block by xsadd_discard(). Small arrays are
+     * filled by the calling thread. If a thread can not be created,
+     * its block is filled by the calling thread.
+     * @param[in,out] xsadd xsadd internal state
+     * @param[out] array the array to be filled
+     * @param[in] size number of elements of the array
+     * @param[in] nthreads number of threads, 1 or less means no
+     * thread is created.
+     */
+    void xsadd_parallel_fill(xsadd_t * xsadd, uint32_t array[], size_t size,
+			     int nthreads);
+
+    /**
+     * This function sets the seed of the root stream of
+     * xsadd_thread_local(). It must be called before the first call of
+     * xsadd_thread_local() in any thread, otherwise the root stream is
+     * initialized by xsadd_init() with seed 1234.
+     * @param[in] seed a 32-bit unsigned integer given to xsadd_init().
+     * @return 0 if success, -1 if the root stream is already
+     * initialized.
+     */
+    int xsadd_thread_local_seed(uint32_t seed);
+
+    /**
+     * This function returns the xsadd state of the calling thread.
+     * At the first call in each thread, the thread takes an index k
+     * from a lock-free atomic counter, and its state is the root
+     * stream jumped by k * xsadd_jump_base_step, so the streams of
+     * threads do not overlap. The jump polynomial of
+     * xsadd_jump_base_step is calculated only once, and a thread
+     * needs only its k-th power. After the first call, this function
+     * only reads a thread local variable.
+     * @return pointer to the xsadd state of the calling thread, valid
+     * until the thread exits.
+     */
+    xsadd_t * xsadd_thread_local(void);
+
+    /**
+     * This function returns the index k of the stream of the calling
+     * thread, see xsadd_thread_local(). The stream is assigned if it
+     * is not yet.
+     * @return the index of the stream of the calling thread.
+     */
+    uint64_t xsadd_thread_local_index(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // XSADD_PARALLEL_H